@@ -0,0 +1,64 @@
+//
+//  AsyncSemaphore.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+// Caps how many callers can be inside `withPermit` at once. Waiters are resumed in
+// FIFO order, and a cancelled waiter leaves the queue with a CancellationError.
+actor AsyncSemaphore {
+
+    private var available:Int
+    private var waiters = [(id:UInt64, continuation:CheckedContinuation<Void,Error>)]()
+    private var nextID:UInt64 = 0
+
+    init(limit:Int) {
+        available = max(1, limit)
+    }
+
+    func wait() async throws {
+        try Task.checkCancellation()
+        if available > 0 {
+            available -= 1
+            return
+        }
+        let id = nextID
+        nextID += 1
+        try await withTaskCancellationHandler {
+            // Appended before the actor is given up, so the cancel hop below always finds it.
+            try await withCheckedThrowingContinuation { continuation in
+                waiters.append((id, continuation))
+            }
+        } onCancel: {
+            Task { await self.cancelWaiter(id) }
+        }
+    }
+
+    func signal() {
+        if waiters.isEmpty {
+            available += 1
+        } else {
+            waiters.removeFirst().continuation.resume()
+        }
+    }
+
+    // A waiter that already got its permit is no longer queued and keeps it.
+    private func cancelWaiter(_ id:UInt64) {
+        guard let index = waiters.firstIndex(where: { $0.id == id }) else { return }
+        waiters.remove(at: index).continuation.resume(throwing: CancellationError())
+    }
+
+    nonisolated func withPermit<T>(_ operation: () async throws -> T) async throws -> T {
+        try await wait()
+        do {
+            let value = try await operation()
+            await signal()
+            return value
+        } catch {
+            await signal()
+            throw error
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//
+//  AudioCallbackProfiler.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import Synchronization
+
+// Lock-free timing for one real-time audio callback. `begin`/`end` only read
+// mach_absolute_time and bump atomics, so they are safe on the audio thread.
+// Durations and inter-arrival jitter go into log2 microsecond histograms.
+// A deadline miss is a callback that runs longer than one buffer period.
+final class AudioCallbackProfiler {
+
+    struct Report:Codable, CustomStringConvertible {
+        var name:String
+        var callbacks:Int
+        var deadlineMisses:Int
+        var lateArrivals:Int
+        var periodMicroseconds:Double
+        var maxDurationMicroseconds:Double
+        var durationP50Microseconds:Double
+        var durationP99Microseconds:Double
+        var jitterP50Microseconds:Double
+        var jitterP99Microseconds:Double
+        // Callback counts per bucket; bucket i holds values below 2^i microseconds.
+        var durationHistogram:[Int]
+        var jitterHistogram:[Int]
+
+        var description: String {
+            "\(name): \(callbacks) callbacks, \(deadlineMisses) deadline misses, \(lateArrivals) late, duration p50 \(durationP50Microseconds) us p99 \(durationP99Microseconds) us max \(String(format: "%.1f", maxDurationMicroseconds)) us, jitter p50 \(jitterP50Microseconds) us p99 \(jitterP99Microseconds) us (period \(String(format: "%.0f", periodMicroseconds)) us)"
+        }
+    }
+
+    static let bucketCount = 24
+
+    let name:String
+    private let periodTicks:UInt64
+    private let ticksPerMicrosecond:Double
+    private let durations:UnsafeMutablePointer<Atomic<Int>>
+    private let jitters:UnsafeMutablePointer<Atomic<Int>>
+    private let callbacks = Atomic<Int>(0)
+    private let deadlineMisses = Atomic<Int>(0)
+    private let lateArrivals = Atomic<Int>(0)
+    private let maxDuration = Atomic<UInt64>(0)
+    private let lastArrival = Atomic<UInt64>(0)
+
+    init(name:String, framesPerBuffer:Int, sampleRate:Int) {
+        self.name = name
+        var timebase = mach_timebase_info_data_t()
+        mach_timebase_info(&timebase)
+        ticksPerMicrosecond = 1000 * Double(timebase.denom) / Double(timebase.numer)
+        periodTicks = UInt64(Double(framesPerBuffer) / Double(sampleRate) * 1_000_000 * ticksPerMicrosecond)
+        durations = .allocate(capacity: AudioCallbackProfiler.bucketCount)
+        jitters = .allocate(capacity: AudioCallbackProfiler.bucketCount)
+        for bucket in 0..<AudioCallbackProfiler.bucketCount {
+            (durations + bucket).initialize(to: Atomic(0))
+            (jitters + bucket).initialize(to: Atomic(0))
+        }
+    }
+
+    deinit {
+        durations.deinitialize(count: AudioCallbackProfiler.bucketCount)
+        jitters.deinitialize(count: AudioCallbackProfiler.bucketCount)
+        durations.deallocate()
+        jitters.deallocate()
+    }
+
+    // Call at the top of the callback and pass the result to `end`. Assumes a
+    // single callback thread, which is how audio units and capture timers run.
+    @inline(__always)
+    func begin() -> UInt64 {
+        let now = mach_absolute_time()
+        let last = lastArrival.load(ordering: .relaxed)
+        lastArrival.store(now, ordering: .relaxed)
+        if last != 0 {
+            let interval = now &- last
+            let jitter = interval > periodTicks ? interval - periodTicks : periodTicks - interval
+            record(jitter, into: jitters)
+            if interval > periodTicks + periodTicks / 2 {
+                _ = lateArrivals.wrappingAdd(1, ordering: .relaxed)
+            }
+        }
+        return now
+    }
+
+    @inline(__always)
+    func end(_ start:UInt64) {
+        let duration = mach_absolute_time() &- start
+        record(duration, into: durations)
+        _ = callbacks.wrappingAdd(1, ordering: .relaxed)
+        if duration > periodTicks {
+            _ = deadlineMisses.wrappingAdd(1, ordering: .relaxed)
+        }
+        if duration > maxDuration.load(ordering: .relaxed) {
+            maxDuration.store(duration, ordering: .relaxed)
+        }
+    }
+
+    func report() -> Report {
+        let durationHistogram = snapshot(durations)
+        let jitterHistogram = snapshot(jitters)
+        return Report(name: name,
+                      callbacks: callbacks.load(ordering: .relaxed),
+                      deadlineMisses: deadlineMisses.load(ordering: .relaxed),
+                      lateArrivals: lateArrivals.load(ordering: .relaxed),
+                      periodMicroseconds: Double(periodTicks) / ticksPerMicrosecond,
+                      maxDurationMicroseconds: Double(maxDuration.load(ordering: .relaxed)) / ticksPerMicrosecond,
+                      durationP50Microseconds: AudioCallbackProfiler.percentile(0.5, of: durationHistogram),
+                      durationP99Microseconds: AudioCallbackProfiler.percentile(0.99, of: durationHistogram),
+                      jitterP50Microseconds: AudioCallbackProfiler.percentile(0.5, of: jitterHistogram),
+                      jitterP99Microseconds: AudioCallbackProfiler.percentile(0.99, of: jitterHistogram),
+                      durationHistogram: durationHistogram,
+                      jitterHistogram: jitterHistogram)
+    }
+
+    // Only valid while the callback is not running.
+    func reset() {
+        for bucket in 0..<AudioCallbackProfiler.bucketCount {
+            durations[bucket].store(0, ordering: .relaxed)
+            jitters[bucket].store(0, ordering: .relaxed)
+        }
+        callbacks.store(0, ordering: .relaxed)
+        deadlineMisses.store(0, ordering: .relaxed)
+        lateArrivals.store(0, ordering: .relaxed)
+        maxDuration.store(0, ordering: .relaxed)
+        lastArrival.store(0, ordering: .relaxed)
+    }
+
+    @inline(__always)
+    private func record(_ ticks:UInt64, into histogram:UnsafeMutablePointer<Atomic<Int>>) {
+        let microseconds = UInt64(Double(ticks) / ticksPerMicrosecond)
+        let bucket = min(AudioCallbackProfiler.bucketCount - 1, 64 - microseconds.leadingZeroBitCount)
+        _ = histogram[bucket].wrappingAdd(1, ordering: .relaxed)
+    }
+
+    private func snapshot(_ histogram:UnsafeMutablePointer<Atomic<Int>>) -> [Int] {
+        (0..<AudioCallbackProfiler.bucketCount).map { histogram[$0].load(ordering: .relaxed) }
+    }
+
+    // Upper bound of the bucket holding the given percentile.
+    private static func percentile(_ fraction:Double, of histogram:[Int]) -> Double {
+        let total = histogram.reduce(0, +)
+        guard total > 0 else { return 0 }
+        let rank = Int((Double(total) * fraction).rounded(.up))
+        var seen = 0
+        for (bucket, count) in histogram.enumerated() {
+            seen += count
+            if seen >= rank {
+                return Double(1 << bucket)
+            }
+        }
+        return Double(1 << (histogram.count - 1))
+    }
+}
@@ -0,0 +1,495 @@
+//
+//  AudioKernelBenchmark.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+#if DEBUG
+import Foundation
+import AVFoundation
+import TwilioVoice
+
+// Microbenchmarks for the real-time audio kernels. Runs after PipelineBenchmark
+// when a Debug build is launched with `-runBenchmarks`. Timings are ns per input
+// frame, to compare against the 10 ms device buffer budget.
+struct AudioKernelBenchmark {
+
+    struct Options {
+        var seconds = 10
+        var chunkMilliseconds = 10
+    }
+
+    var options = Options()
+
+    typealias JitterReplay = (network:String, calls:Int, poorCalls:Int, settings:JitterBufferSettings?, deterministic:Bool, nanosecondsPerDecision:Double)
+
+    func run() -> [BenchmarkCheck] {
+        var checks = [BenchmarkCheck]()
+        let ringIntact = verifyRingConcurrentIntegrity()
+        print("Benchmark SPSC ring concurrent integrity: \(ringIntact)")
+        checks.append(BenchmarkCheck(name: "SPSC ring concurrent integrity", passed: ringIntact))
+        for rate in PCMConverter.supportedRates {
+            for channels in [1, 2] {
+                let format = AudioFormat(channels: channels, sampleRate: UInt32(rate), framesPerBuffer: rate / 100)!
+                // The hardware rarely matches the SDK's 10 ms buffers; iOS tends to round up to a power of two.
+                let hardwareFrames = 1 << (Int.bitWidth - (format.framesPerBuffer - 1).leadingZeroBitCount)
+                for frames in [format.framesPerBuffer, hardwareFrames] {
+                    for jitter in [Duration.zero, .milliseconds(4)] {
+                        let xruns = ringDeviceXruns(format: format, hardwareFrames: frames, pumpJitter: jitter)
+                        print("Benchmark RingBufferAudioDevice \(rate)x\(channels) hw \(frames) frames, pump jitter \(jitter): \(xruns.renderUnderruns) underruns, \(xruns.captureOverruns) overruns, \(xruns.discontinuities) discontinuities")
+                        // Xruns can happen under jitter, but they must never reorder or corrupt samples.
+                        checks.append(BenchmarkCheck(name: "RingBufferAudioDevice \(rate)x\(channels) hw \(frames) jitter \(jitter) continuity",
+                                                     passed: xruns.discontinuities == 0))
+                    }
+                }
+            }
+        }
+        let bitExact = verifyConverterBitExact()
+        print("Benchmark PCMConverter bit-exact: \(bitExact)")
+        checks.append(BenchmarkCheck(name: "PCMConverter bit-exact", passed: bitExact))
+        for sourceRate in PCMConverter.supportedRates {
+            for targetRate in PCMConverter.supportedRates where targetRate < sourceRate {
+                let response = converterResponse(sourceRate: sourceRate, targetRate: targetRate)
+                print("Benchmark PCMConverter \(sourceRate) -> \(targetRate) response: passband \(String(format: "%.1f", response.passband)) dB, above target Nyquist \(String(format: "%.1f", response.aliased)) dB")
+                checks.append(BenchmarkCheck(name: "PCMConverter \(sourceRate) -> \(targetRate) anti-aliasing",
+                                             passed: response.passband > -1.5 && response.aliased < -40))
+            }
+        }
+        for sourceRate in PCMConverter.supportedRates {
+            for targetRate in PCMConverter.supportedRates where targetRate != sourceRate {
+                for (sourceChannels, targetChannels) in [(1, 1), (2, 1), (1, 2), (2, 2)] {
+                    let scalar = converterNanosecondsPerFrame(sourceRate: sourceRate, sourceChannels: sourceChannels,
+                                                              targetRate: targetRate, targetChannels: targetChannels, path: .scalar)
+                    let vector = converterNanosecondsPerFrame(sourceRate: sourceRate, sourceChannels: sourceChannels,
+                                                              targetRate: targetRate, targetChannels: targetChannels, path: .vector)
+                    print("Benchmark PCMConverter \(sourceRate)x\(sourceChannels) -> \(targetRate)x\(targetChannels): scalar \(String(format: "%.2f", scalar)) ns/frame, vector \(String(format: "%.2f", vector)) ns/frame")
+                }
+            }
+        }
+        let (scalarLevel, vectorLevel) = meterSamplesPerNanosecond()
+        print("Benchmark AudioLevelMeter: scalar \(String(format: "%.3f", scalarLevel)) samples/ns, vector \(String(format: "%.3f", vectorLevel)) samples/ns")
+        let trimmed = verifySilenceTrimmerOnWAV()
+        print("Benchmark SilenceTrimmer WAV fixture: \(trimmed)")
+        checks.append(BenchmarkCheck(name: "SilenceTrimmer WAV fixture", passed: trimmed))
+        if let assets = assetLoadComparison() {
+            print("Benchmark PCM asset \(assets.seconds) s: whole file read \(assets.readLatency) first frame, +\(assets.readResident / 1024) KiB resident; mapped \(assets.mappedLatency) first frame, +\(assets.mappedResident / 1024) KiB resident")
+        }
+        let (contiguous, reframed) = reframerCopiedBytesPerSecond()
+        print("Benchmark capture framing memcpy: contiguous copy \(contiguous / 1024) KiB/s of audio, reframer \(reframed / 1024) KiB/s of audio")
+        for replay in jitterPolicyReplay() {
+            print("Benchmark jitter buffer replay \(replay.network): settled \(replay.settings.map { "\($0.minimumDelayMilliseconds) ms / \($0.maximumPackets) packets" } ?? "defaults"), concealment in \(replay.poorCalls) of \(replay.calls) calls, deterministic \(replay.deterministic), \(String(format: "%.0f", replay.nanosecondsPerDecision)) ns/decision")
+            checks.append(BenchmarkCheck(name: "jitter buffer replay \(replay.network) deterministic", passed: replay.deterministic))
+        }
+        return checks
+    }
+
+    // Plays synthetic ramps through RingBufferAudioDevice's real-time callbacks
+    // on a simulated clock. The render and capture callbacks tick every
+    // `hardwareFrames`; the pump ticks every half SDK buffer as on device, late
+    // by up to `pumpJitter`, and moves whole `framesPerBuffer` chunks. Any
+    // sample that comes out of a ring out of sequence is a discontinuity.
+    func ringDeviceXruns(format:AudioFormat, hardwareFrames:Int, pumpJitter:Duration) -> (renderUnderruns:Int, captureOverruns:Int, discontinuities:Int) {
+        let harness = RingBufferAudioDevice.Harness(format: format)
+        let sampleRate = Double(format.sampleRate)
+        let chunk = format.framesPerBuffer * format.numberOfChannels
+        let callbackPeriod = Double(hardwareFrames) / sampleRate
+        let pumpPeriod = Double(format.framesPerBuffer) / sampleRate / 2
+        let end = Double(options.seconds)
+        var generator = SplitMix64(seed: 11)
+        let pumpBuffer = UnsafeMutablePointer<Int16>.allocate(capacity: chunk)
+        defer { pumpBuffer.deallocate() }
+        var renderNext:Int16 = 0
+        var renderExpected:Int16 = 0
+        var captureNext:Int16 = 0
+        var captureExpected:Int16 = 0
+        var discontinuities = 0
+        var callbackTick = 0
+        var pumpTick = 0
+        var pumpTime = 0.0
+        while true {
+            let callbackTime = Double(callbackTick) * callbackPeriod
+            guard min(callbackTime, pumpTime) < end else { break }
+            // On device the pump timer starts before the audio unit, so it wins ties.
+            if callbackTime < pumpTime {
+                let available = harness.renderRing.availableToRead
+                let played = harness.render(frames: hardwareFrames)
+                for (index, sample) in played.enumerated() {
+                    if index < available {
+                        if sample != renderExpected {
+                            discontinuities += 1
+                        }
+                        renderExpected = sample &+ 1
+                    } else if sample != 0 {
+                        discontinuities += 1
+                    }
+                }
+                // A full ring drops the tail of the buffer, so only what fits continues the ramp.
+                let room = harness.captureRing.availableToWrite
+                harness.capture(frames: hardwareFrames) { samples, count in
+                    for index in 0..<count {
+                        samples[index] = captureNext &+ Int16(truncatingIfNeeded: index)
+                    }
+                }
+                captureNext = captureNext &+ Int16(truncatingIfNeeded: min(room, hardwareFrames * format.numberOfChannels))
+                callbackTick += 1
+            } else {
+                while harness.captureRing.availableToRead >= chunk {
+                    harness.captureRing.read(into: pumpBuffer, count: chunk)
+                    for index in 0..<chunk {
+                        if pumpBuffer[index] != captureExpected {
+                            discontinuities += 1
+                        }
+                        captureExpected = pumpBuffer[index] &+ 1
+                    }
+                }
+                while harness.renderRing.availableToRead < chunk * 2 && harness.renderRing.availableToWrite >= chunk {
+                    for index in 0..<chunk {
+                        pumpBuffer[index] = renderNext
+                        renderNext &+= 1
+                    }
+                    harness.renderRing.write(pumpBuffer, count: chunk)
+                }
+                pumpTick += 1
+                let late = pumpJitter == .zero ? 0 : Double(generator.next() % 1000) / 1000 * pumpJitter.timeInterval
+                pumpTime = Double(pumpTick) * pumpPeriod + late
+            }
+        }
+        return (harness.renderUnderruns, harness.captureOverruns, discontinuities)
+    }
+
+    // Hammers one SPSCRingBuffer from a producer and a consumer thread with
+    // uneven chunk sizes and checks every sample arrives once, in order.
+    func verifyRingConcurrentIntegrity() -> Bool {
+        let ring = SPSCRingBuffer(minimumCapacity: 4096)
+        let total = 20_000_000
+        let done = DispatchSemaphore(value: 0)
+        let producer = Thread {
+            var generator = SplitMix64(seed: 3)
+            let buffer = UnsafeMutablePointer<Int16>.allocate(capacity: 1024)
+            defer { buffer.deallocate() }
+            var next = 0
+            while next < total {
+                let count = min(Int(generator.next() % 1024) + 1, total - next)
+                for index in 0..<count {
+                    buffer[index] = Int16(truncatingIfNeeded: next + index)
+                }
+                var written = 0
+                while written < count {
+                    written += ring.write(buffer + written, count: count - written)
+                }
+                next += count
+            }
+            done.signal()
+        }
+        producer.start()
+        var generator = SplitMix64(seed: 4)
+        let buffer = UnsafeMutablePointer<Int16>.allocate(capacity: 1024)
+        defer { buffer.deallocate() }
+        var expected = 0
+        var intact = true
+        while expected < total {
+            let read = ring.read(into: buffer, count: Int(generator.next() % 1024) + 1)
+            for index in 0..<read where buffer[index] != Int16(truncatingIfNeeded: expected + index) {
+                intact = false
+            }
+            expected += read
+        }
+        done.wait()
+        return intact
+    }
+
+    // Replays synthetic call histories for three network classes through
+    // JitterBufferPolicy, with a simple far end whose MOS drops when jitter
+    // peaks outrun the buffer delay. Each call feeds back the settings it ran
+    // with, as JitterBufferTuner does, and a second pass over the same records
+    // must reproduce every decision.
+    func jitterPolicyReplay() -> [JitterReplay] {
+        let policy = JitterBufferPolicy()
+        let calls = 200
+        let pollsPerCall = 60
+        let networks:[(name:String, jitter:Double, spread:Double, mos:Double)] = [
+            ("wifi", 4, 6, 4.4),
+            ("cellular", 20, 40, 4.1),
+            ("congested", 45, 120, 3.9)
+        ]
+        var results = [JitterReplay]()
+        for network in networks {
+            var generator = SplitMix64(seed: 25)
+            var records = [JitterCallRecord]()
+            var decisions = [JitterBufferSettings?]()
+            var poorCalls = 0
+            for _ in 0..<calls {
+                let settings = policy.decide(history: records)
+                decisions.append(settings)
+                let delay = Double(settings?.minimumDelayMilliseconds ?? 0)
+                let store = CallStatsStore()
+                var concealed = 0
+                for poll in 0..<pollsPerCall {
+                    // Mostly steady jitter with occasional bursts up to `spread` above it.
+                    let burst = generator.next() % 10 == 0 ? Double(generator.next() % 1000) / 1000 * network.spread : 0
+                    let jitter = network.jitter * (0.5 + Double(generator.next() % 1000) / 1000) + burst
+                    if jitter > max(delay, 20) {
+                        concealed += 1
+                    }
+                    let mos = network.mos - Double(concealed) / Double(poll + 1) * 2
+                    store.append([Int32(poll * 2000), Int32(jitter), Int32(mos * 1000), 50, Int32(concealed), 0, 0])
+                }
+                if let record = JitterCallRecord(history: store, settings: settings) {
+                    if record.mos < policy.poorMos {
+                        poorCalls += 1
+                    }
+                    records.append(record)
+                }
+            }
+            let clock = ContinuousClock()
+            var deterministic = true
+            let elapsed = clock.measure {
+                for index in 0..<decisions.count {
+                    deterministic = deterministic && policy.decide(history: Array(records.prefix(index))) == decisions[index]
+                }
+            }
+            results.append((network.name, calls, poorCalls, decisions.last ?? nil, deterministic,
+                            elapsed.timeInterval * 1e9 / Double(decisions.count)))
+        }
+        return results
+    }
+
+    // Feeds TTS-sized chunks of uneven length through the old approach (append
+    // everything into one array, then slice) and through CaptureReframer, and
+    // returns the bytes each one copies per second of 48 kHz mono audio.
+    func reframerCopiedBytesPerSecond() -> (contiguous:Int, reframed:Int) {
+        let framesPerBuffer = 480
+        var generator = SplitMix64(seed: 3)
+        let chunkSizes = (0..<options.seconds * 20).map { _ in Int.random(in: 256...4096, using: &generator) }
+        let totalSamples = chunkSizes.reduce(0, +)
+        // One backing allocation stands in for the separate buffers a TTS engine hands out.
+        let backing = UnsafeMutablePointer<Int16>.allocate(capacity: totalSamples)
+        backing.initialize(repeating: 0, count: totalSamples)
+        defer { backing.deallocate() }
+
+        var contiguous = [Int16]()
+        var offset = 0
+        for size in chunkSizes {
+            contiguous.append(contentsOf: UnsafeBufferPointer(start: backing + offset, count: size))
+            offset += size
+        }
+        // Every sample is copied once into the array, plus the zero padding that completes the last buffer.
+        let padding = (framesPerBuffer - contiguous.count % framesPerBuffer) % framesPerBuffer
+        let contiguousBytes = (contiguous.count + padding) * MemoryLayout<Int16>.size
+
+        let reframer = CaptureReframer(framesPerBuffer: framesPerBuffer, channels: 1)
+        offset = 0
+        for size in chunkSizes {
+            reframer.append(backing + offset, count: size, owner: nil)
+            offset += size
+        }
+        var checksum = 0
+        while reframer.emitRemainder({ checksum &+= Int($0[0]) }) {}
+        _ = checksum
+
+        let seconds = Double(totalSamples) / 48000
+        return (Int(Double(contiguousBytes) / seconds), Int(Double(reframer.copiedBytes) / seconds))
+    }
+
+    // Writes a WAV fixture of silence and tone segments, reads it back through
+    // AVAudioFile and checks the trimmer drops exactly the expected silence.
+    func verifySilenceTrimmerOnWAV() -> Bool {
+        let sampleRate = 48000
+        // (milliseconds, voiced)
+        let segments = [(500, false), (1000, true), (1500, false), (1000, true), (800, false)]
+        let url = FileManager.default.temporaryDirectory.appending(path: "silence-fixture.wav")
+        defer { try? FileManager.default.removeItem(at: url) }
+        guard let format = AVAudioFormat(commonFormat: .pcmFormatInt16, sampleRate: Double(sampleRate), channels: 1, interleaved: true) else { return false }
+        do {
+            let file = try AVAudioFile(forWriting: url, settings: format.settings, commonFormat: .pcmFormatInt16, interleaved: true)
+            for (milliseconds, voiced) in segments {
+                let frames = sampleRate * milliseconds / 1000
+                guard let buffer = AVAudioPCMBuffer(pcmFormat: format, frameCapacity: AVAudioFrameCount(frames)) else { return false }
+                buffer.frameLength = AVAudioFrameCount(frames)
+                for frame in 0..<frames {
+                    buffer.int16ChannelData![0][frame] = voiced ? Int16(8000 * sin(2 * Double.pi * 440 * Double(frame) / Double(sampleRate))) : 0
+                }
+                try file.write(from: buffer)
+            }
+        } catch {
+            print("Failed to write WAV fixture \(error.localizedDescription)")
+            return false
+        }
+
+        let trimmer = SilenceTrimmer(sampleRate: sampleRate, channels: 1, framesPerBuffer: 480)
+        var kept = 0
+        do {
+            let file = try AVAudioFile(forReading: url, commonFormat: .pcmFormatInt16, interleaved: true)
+            // Read several device buffers at a time, like a decoder would hand them over.
+            guard let buffer = AVAudioPCMBuffer(pcmFormat: file.processingFormat, frameCapacity: 1440) else { return false }
+            while file.framePosition < file.length {
+                try file.read(into: buffer)
+                trimmer.consume(buffer.int16ChannelData![0], count: Int(buffer.frameLength)) { kept += $1 }
+            }
+            trimmer.finish { kept += $1 }
+        } catch {
+            print("Failed to read WAV fixture \(error.localizedDescription)")
+            return false
+        }
+        let stats = trimmer.stats
+        let expected = (leading: 440, pause: 1100, trailing: 650)
+        let milliseconds = { (samples:Int) in samples * 1000 / sampleRate }
+        print("SilenceTrimmer trimmed \(stats.trimmedDuration) of \(stats.inputDuration): leading \(milliseconds(stats.leadingTrimmed)) ms, pause \(milliseconds(stats.pauseTrimmed)) ms, trailing \(milliseconds(stats.trailingTrimmed)) ms")
+        return milliseconds(stats.leadingTrimmed) == expected.leading
+            && milliseconds(stats.pauseTrimmed) == expected.pause
+            && milliseconds(stats.trailingTrimmed) == expected.trailing
+            && kept + stats.trimmedSamples == stats.inputSamples
+    }
+
+    // Time to the first frame and resident growth for a two-minute summary, read
+    // whole into Data versus mapped through PCMAsset.
+    func assetLoadComparison() -> (seconds:Int, readLatency:Duration, readResident:Int, mappedLatency:Duration, mappedResident:Int)? {
+        let seconds = 120
+        let sampleRate = 48000
+        let store = PCMAssetStore(directory: FileManager.default.temporaryDirectory.appending(path: "pcm-benchmark"))
+        defer { try? FileManager.default.removeItem(at: store.directory) }
+        let chunk = [Int16](repeating: 1, count: sampleRate)
+        do {
+            try store.write(forKey: "benchmark", sampleRate: sampleRate, channels: 1, framesPerBuffer: 480) { handle in
+                for _ in 0..<seconds {
+                    try chunk.withUnsafeBytes { try handle.write(contentsOf: Data($0)) }
+                }
+                return sampleRate * seconds
+            }
+            store.evictAll()
+        } catch {
+            print("Failed to write benchmark asset \(error.localizedDescription)")
+            return nil
+        }
+        let url = store.url(forKey: "benchmark")
+        let clock = ContinuousClock()
+        var sink = 0
+
+        var resident = BenchmarkMemory.residentBytes()
+        var start = clock.now
+        guard let data = try? Data(contentsOf: url) else { return nil }
+        sink &+= Int(data[PCMAsset.dataOffset])
+        let readLatency = start.duration(to: clock.now)
+        let readResident = BenchmarkMemory.residentBytes() - resident
+
+        resident = BenchmarkMemory.residentBytes()
+        start = clock.now
+        guard let asset = try? PCMAsset(url: url) else { return nil }
+        sink &+= Int(asset.samples[0])
+        let mappedLatency = start.duration(to: clock.now)
+        let mappedResident = BenchmarkMemory.residentBytes() - resident
+
+        withExtendedLifetime((data, asset, sink)) {}
+        return (seconds, readLatency, readResident, mappedLatency, mappedResident)
+    }
+
+    // Throughput of the per-sample and SIMD level kernels over 10 ms 48 kHz buffers.
+    func meterSamplesPerNanosecond() -> (scalar:Double, vector:Double) {
+        var generator = SplitMix64(seed: 11)
+        let samples = (0..<480).map { _ in Int16(truncatingIfNeeded: generator.next()) }
+        let buffers = options.seconds * 1000 / options.chunkMilliseconds * 10
+        let clock = ContinuousClock()
+        var sink:Float = 0
+        let scalar = clock.measure {
+            for _ in 0..<buffers {
+                sink += AudioLevelMeter.levelScalar(of: samples, count: samples.count).rms
+            }
+        }
+        let vector = clock.measure {
+            for _ in 0..<buffers {
+                sink += AudioLevelMeter.level(of: samples, count: samples.count).rms
+            }
+        }
+        _ = sink
+        let total = Double(buffers * samples.count)
+        return (total / (scalar.timeInterval * 1e9), total / (vector.timeInterval * 1e9))
+    }
+
+    // Runs the scalar and vector paths over every rate and channel pair with
+    // uneven chunk sizes and reports whether every output sample matches.
+    func verifyConverterBitExact() -> Bool {
+        var generator = SplitMix64(seed: 42)
+        let chunkSizes = [1, 7, 80, 441, 480, 1023]
+        for sourceRate in PCMConverter.supportedRates {
+            for targetRate in PCMConverter.supportedRates {
+                for (sourceChannels, targetChannels) in [(1, 1), (2, 1), (1, 2), (2, 2)] {
+                    let scalar = PCMConverter(sourceRate: sourceRate, sourceChannels: sourceChannels, targetRate: targetRate,
+                                              targetChannels: targetChannels, maximumInputFrames: chunkSizes.max()!)
+                    let vector = PCMConverter(sourceRate: sourceRate, sourceChannels: sourceChannels, targetRate: targetRate,
+                                              targetChannels: targetChannels, maximumInputFrames: chunkSizes.max()!)
+                    scalar.path = .scalar
+                    for frames in chunkSizes {
+                        let input = (0..<frames * sourceChannels).map { _ in Int16(truncatingIfNeeded: generator.next()) }
+                        let capacity = scalar.maximumOutputFrames(forInputFrames: frames) * targetChannels
+                        var expected = [Int16](repeating: 0, count: capacity)
+                        var actual = [Int16](repeating: 0, count: capacity)
+                        let expectedFrames = expected.withUnsafeMutableBufferPointer { scalar.convert(input, frames: frames, into: $0.baseAddress!) }
+                        let actualFrames = actual.withUnsafeMutableBufferPointer { vector.convert(input, frames: frames, into: $0.baseAddress!) }
+                        if expectedFrames != actualFrames || expected != actual {
+                            print("PCMConverter mismatch \(sourceRate)x\(sourceChannels) -> \(targetRate)x\(targetChannels) chunk \(frames)")
+                            return false
+                        }
+                    }
+                }
+            }
+        }
+        return true
+    }
+
+    // Gain in dB of a mono tone at 20% of the target rate, which should pass,
+    // and of one halfway between the target and source Nyquist, which without
+    // the low-pass would fold back into the output at nearly full level.
+    func converterResponse(sourceRate:Int, targetRate:Int) -> (passband:Double, aliased:Double) {
+        func gain(frequency:Double) -> Double {
+            let frames = sourceRate
+            let converter = PCMConverter(sourceRate: sourceRate, sourceChannels: 1, targetRate: targetRate,
+                                         targetChannels: 1, maximumInputFrames: frames)
+            let input = (0..<frames).map { Int16(16_384 * sin(2 * .pi * frequency * Double($0) / Double(sourceRate))) }
+            var output = [Int16](repeating: 0, count: converter.maximumOutputFrames(forInputFrames: frames))
+            let produced = output.withUnsafeMutableBufferPointer { converter.convert(input, frames: frames, into: $0.baseAddress!) }
+            // Skip the filter's warm-up.
+            let settled = output[(produced / 10)..<produced]
+            let power = settled.reduce(0.0) { $0 + Double($1) * Double($1) } / Double(settled.count)
+            return 10 * log10(max(power, 1e-3) / (16_384.0 * 16_384.0 / 2))
+        }
+        return (gain(frequency: 0.2 * Double(targetRate)), gain(frequency: Double(targetRate + sourceRate) / 4))
+    }
+
+    private func converterNanosecondsPerFrame(sourceRate:Int, sourceChannels:Int, targetRate:Int, targetChannels:Int, path:PCMConverter.Path) -> Double {
+        let chunk = sourceRate * options.chunkMilliseconds / 1000
+        let converter = PCMConverter(sourceRate: sourceRate, sourceChannels: sourceChannels, targetRate: targetRate,
+                                     targetChannels: targetChannels, maximumInputFrames: chunk)
+        converter.path = path
+        var generator = SplitMix64(seed: 7)
+        let input = (0..<chunk * sourceChannels).map { _ in Int16(truncatingIfNeeded: generator.next()) }
+        var output = [Int16](repeating: 0, count: converter.maximumOutputFrames(forInputFrames: chunk) * targetChannels)
+        let chunks = options.seconds * 1000 / options.chunkMilliseconds
+        let clock = ContinuousClock()
+        let elapsed = output.withUnsafeMutableBufferPointer { buffer in
+            clock.measure {
+                for _ in 0..<chunks {
+                    converter.convert(input, frames: chunk, into: buffer.baseAddress!)
+                }
+            }
+        }
+        return elapsed.timeInterval * 1e9 / Double(chunks * chunk)
+    }
+}
+
+// Small deterministic generator so benchmark inputs are the same on every run.
+struct SplitMix64:RandomNumberGenerator {
+    private var state:UInt64
+
+    init(seed:UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+}
+#endif
@@ -0,0 +1,85 @@
+//
+//  AudioLevelMeter.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import Synchronization
+
+// RMS and peak level of each capture buffer, computed with SIMD as the buffer is
+// handed to AudioDeviceWriteCaptureData. The latest level is published as one
+// packed 64-bit atomic, so the UI can read it every frame without locks and
+// without polling Call.getStats for audioLevel.
+final class AudioLevelMeter {
+
+    // Both values are normalized to 0...1 of int16 full scale.
+    struct Level:Equatable {
+        var rms:Float
+        var peak:Float
+
+        static let silent = Level(rms: 0, peak: 0)
+    }
+
+    private let snapshot = Atomic<UInt64>(0)
+
+    var level:Level {
+        let packed = snapshot.load(ordering: .relaxed)
+        return Level(rms: Float(bitPattern: UInt32(truncatingIfNeeded: packed >> 32)),
+                     peak: Float(bitPattern: UInt32(truncatingIfNeeded: packed)))
+    }
+
+    // Safe on the audio thread: no locks, no allocation.
+    @inline(__always)
+    func measure(_ samples:UnsafePointer<Int16>, count:Int) {
+        publish(AudioLevelMeter.level(of: samples, count: count))
+    }
+
+    func reset() {
+        publish(.silent)
+    }
+
+    private func publish(_ level:Level) {
+        snapshot.store(UInt64(level.rms.bitPattern) << 32 | UInt64(level.peak.bitPattern), ordering: .relaxed)
+    }
+
+    // MARK: Kernels
+
+    static func level(of samples:UnsafePointer<Int16>, count:Int) -> Level {
+        guard count > 0 else { return .silent }
+        var squares = SIMD16<Float>()
+        var lowest = SIMD16<Int16>(repeating: 0)
+        var highest = SIMD16<Int16>(repeating: 0)
+        var index = 0
+        while index + 16 <= count {
+            let vector = UnsafeRawPointer(samples + index).loadUnaligned(as: SIMD16<Int16>.self)
+            let values = SIMD16<Float>(vector)
+            squares.addProduct(values, values)
+            lowest = pointwiseMin(lowest, vector)
+            highest = pointwiseMax(highest, vector)
+            index += 16
+        }
+        var sum = squares.sum()
+        var peak = max(-Int32(lowest.min()), Int32(highest.max()))
+        while index < count {
+            let value = Int32(samples[index])
+            sum += Float(value * value)
+            peak = max(peak, abs(value))
+            index += 1
+        }
+        return Level(rms: (sum / Float(count)).squareRoot() / 32768, peak: Float(peak) / 32768)
+    }
+
+    // Reference per-sample loop, kept for the benchmark.
+    static func levelScalar(of samples:UnsafePointer<Int16>, count:Int) -> Level {
+        guard count > 0 else { return .silent }
+        var sum:Float = 0
+        var peak:Int32 = 0
+        for index in 0..<count {
+            let value = Int32(samples[index])
+            sum += Float(value * value)
+            peak = max(peak, abs(value))
+        }
+        return Level(rms: (sum / Float(count)).squareRoot() / 32768, peak: Float(peak) / 32768)
+    }
+}
@@ -0,0 +1,125 @@
+//
+//  AudioWorkerScheduler.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import os
+import TwilioVoice
+
+// Coalesces audio session events and runs them in batches on the SDK's audio
+// worker thread via AudioDeviceExecuteWorkerBlock. Events posted while a batch
+// is pending are merged into it, so a burst of route changes costs one
+// AudioDeviceReinitialize instead of one per notification.
+final class AudioWorkerScheduler {
+
+    struct Events:OptionSet {
+        let rawValue:UInt8
+
+        // Route, category and media services changes; the SDK re-reads the formats.
+        static let reinitialize = Events(rawValue: 1 << 0)
+        static let interruptionBegan = Events(rawValue: 1 << 1)
+        static let interruptionEnded = Events(rawValue: 1 << 2)
+    }
+
+    struct Stats {
+        var posted = 0
+        var batches = 0
+        var lastLatency = Duration.zero
+        var maxLatency = Duration.zero
+        var totalLatency = Duration.zero
+
+        var coalesced:Int {
+            max(0, posted - batches)
+        }
+
+        var averageLatency:Duration {
+            batches == 0 ? .zero : totalLatency / batches
+        }
+    }
+
+    private struct State {
+        var context:AudioDeviceContext?
+        var pending:Events = []
+        var firstPosted:ContinuousClock.Instant?
+        var stats = Stats()
+    }
+
+    typealias Handler = (Events, AudioDeviceContext) -> Void
+
+    let coalescingWindow:Duration
+    private let handler:Handler
+    private let clock = ContinuousClock()
+    private let queue = DispatchQueue(label: "AudioWorkerScheduler")
+    private let state = OSAllocatedUnfairLock(initialState: State())
+
+    init(coalescingWindow:Duration = .milliseconds(50), handler: @escaping Handler) {
+        self.coalescingWindow = coalescingWindow
+        self.handler = handler
+    }
+
+    // Events are dropped while there is no context, i.e. while the device is stopped.
+    var context:AudioDeviceContext? {
+        get { state.withLock { $0.context } }
+        set {
+            state.withLock { state in
+                state.context = newValue
+                if newValue == nil {
+                    state.pending = []
+                    state.firstPosted = nil
+                }
+            }
+        }
+    }
+
+    var stats:Stats {
+        state.withLock { $0.stats }
+    }
+
+    func post(_ events:Events) {
+        let now = clock.now
+        let schedule = state.withLock { state -> Bool in
+            guard state.context != nil else { return false }
+            state.stats.posted += 1
+            // Only the latest interruption transition matters.
+            if events.contains(.interruptionBegan) {
+                state.pending.remove(.interruptionEnded)
+            }
+            if events.contains(.interruptionEnded) {
+                state.pending.remove(.interruptionBegan)
+            }
+            state.pending.formUnion(events)
+            guard state.firstPosted == nil else { return false }
+            state.firstPosted = now
+            return true
+        }
+        guard schedule else { return }
+        queue.asyncAfter(deadline: .now() + coalescingWindow.timeInterval) { [weak self] in
+            guard let self, let context = self.context else { return }
+            AudioDeviceExecuteWorkerBlock(context: context) { [weak self] in
+                self?.runBatch()
+            }
+        }
+    }
+
+    private func runBatch() {
+        let batch = state.withLock { state -> (Events, AudioDeviceContext?, ContinuousClock.Instant?) in
+            defer {
+                state.pending = []
+                state.firstPosted = nil
+            }
+            return (state.pending, state.context, state.firstPosted)
+        }
+        let (events, context, firstPosted) = batch
+        guard let context, let firstPosted, !events.isEmpty else { return }
+        handler(events, context)
+        let latency = firstPosted.duration(to: clock.now)
+        state.withLock { state in
+            state.stats.batches += 1
+            state.stats.lastLatency = latency
+            state.stats.maxLatency = max(state.stats.maxLatency, latency)
+            state.stats.totalLatency += latency
+        }
+    }
+}
@@ -0,0 +1,214 @@
+//
+//  BatchSummaryEngine.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+struct BatchAccount:Codable, Hashable {
+    var accountUid:String
+    var customerName:String
+}
+
+struct BatchReport:CustomStringConvertible {
+    var succeeded = 0
+    var skipped = 0
+    var failed = [String]()
+    var elapsed:Duration = .zero
+    var latencies = [Duration]()
+
+    var accountsPerMinute:Double {
+        let seconds = elapsed.timeInterval
+        return seconds > 0 ? Double(succeeded) / seconds * 60 : 0
+    }
+
+    func percentile(_ p:Double) -> Duration {
+        guard !latencies.isEmpty else { return .zero }
+        let sorted = latencies.sorted()
+        let index = Int((Double(sorted.count - 1) * p).rounded())
+        return sorted[index]
+    }
+
+    var description: String {
+        "succeeded \(succeeded), skipped \(skipped), failed \(failed.count), \(String(format: "%.1f", accountsPerMinute)) accounts/min, p50 \(percentile(0.5)), p99 \(percentile(0.99))"
+    }
+}
+
+extension Duration {
+    var timeInterval:TimeInterval {
+        Double(components.seconds) + Double(components.attoseconds) / 1e18
+    }
+}
+
+// Runs fetch -> summarize -> deliver for many accounts. Each upstream has its own
+// concurrency limit, at most `Limits.inFlight` accounts are in progress at a time,
+// stages that fail transiently are retried with jittered exponential backoff, and
+// completed accounts are checkpointed so an interrupted run can be resumed.
+final class BatchSummaryEngine {
+
+    struct Limits {
+        var inFlight = 32
+        var starling = 8
+        var chatgpt = 4
+        var delivery = 4
+    }
+
+    struct RetryPolicy {
+        var maxAttempts = 3
+        var baseDelay:TimeInterval = 0.5
+        var maxDelay:TimeInterval = 10
+
+        // Transport failures, throttling and server faults can clear on their own;
+        // other statuses, decoding errors and cancellation cannot.
+        func shouldRetry(_ error:Error) -> Bool {
+            switch error {
+            case let error as HTTPStatusError:
+                return error.statusCode == 429 || (500..<600).contains(error.statusCode)
+            case let error as URLError:
+                return [.timedOut, .networkConnectionLost, .notConnectedToInternet, .cannotConnectToHost,
+                        .cannotFindHost, .dnsLookupFailed, .resourceUnavailable, .dataNotAllowed].contains(error.code)
+            default:
+                return false
+            }
+        }
+    }
+
+    typealias Delivery = (BatchAccount, String) async throws -> Void
+
+    private let starlingService:StarlingService
+    private let chatgptService:ChatGPTService
+    private let promptCompactor:PromptCompactor
+    private let limits:Limits
+    private let retryPolicy:RetryPolicy
+    private let checkpointURL:URL?
+    private let deliver:Delivery
+    private let starlingPermits:AsyncSemaphore
+    private let chatgptPermits:AsyncSemaphore
+    private let deliveryPermits:AsyncSemaphore
+
+    init(starlingService:StarlingService = StarlingService(),
+         chatgptService:ChatGPTService = ChatGPTService(),
+         promptCompactor:PromptCompactor = PromptCompactor(),
+         limits:Limits = Limits(),
+         retryPolicy:RetryPolicy = RetryPolicy(),
+         checkpointURL:URL? = nil,
+         deliver: @escaping Delivery) {
+        self.starlingService = starlingService
+        self.chatgptService = chatgptService
+        self.promptCompactor = promptCompactor
+        self.limits = limits
+        self.retryPolicy = retryPolicy
+        self.checkpointURL = checkpointURL
+        self.deliver = deliver
+        starlingPermits = AsyncSemaphore(limit: limits.starling)
+        chatgptPermits = AsyncSemaphore(limit: limits.chatgpt)
+        deliveryPermits = AsyncSemaphore(limit: limits.delivery)
+    }
+
+    func run(accounts:[BatchAccount]) async -> BatchReport {
+        let clock = ContinuousClock()
+        let start = clock.now
+        var completed = loadCheckpoint()
+        var report = BatchReport()
+        var pending = accounts.filter { !completed.contains($0.accountUid) }[...]
+        report.skipped = accounts.count - pending.count
+
+        await withTaskGroup(of: (BatchAccount, Duration?).self) { group in
+            for _ in 0..<max(1, limits.inFlight) {
+                guard let account = pending.popFirst() else { break }
+                group.addTask { await self.timedProcess(account) }
+            }
+            // A new account is only started when one finishes, which bounds the work in flight.
+            while let result = await group.next() {
+                let (account, latency) = result
+                if let latency {
+                    report.succeeded += 1
+                    report.latencies.append(latency)
+                    completed.insert(account.accountUid)
+                    if report.succeeded % 25 == 0 {
+                        saveCheckpoint(completed)
+                    }
+                } else {
+                    report.failed.append(account.accountUid)
+                }
+                // Once cancelled, let the accounts in flight unwind and leave the rest for a resumed run.
+                if !Task.isCancelled, let next = pending.popFirst() {
+                    group.addTask { await self.timedProcess(next) }
+                }
+            }
+        }
+
+        saveCheckpoint(completed)
+        report.elapsed = start.duration(to: clock.now)
+        print("Batch summary finished \(report)")
+        return report
+    }
+
+    private func timedProcess(_ account:BatchAccount) async -> (BatchAccount, Duration?) {
+        let clock = ContinuousClock()
+        let start = clock.now
+        var latency:Duration?
+        do {
+            try await process(account)
+            latency = start.duration(to: clock.now)
+        } catch {
+            print("Failed to summarise account \(account.accountUid) \(error.localizedDescription)")
+        }
+        // Each account is fetched once per run, so its validators are dead weight afterwards.
+        await starlingService.validators.removeEntries(forAccount: account.accountUid)
+        return (account, latency)
+    }
+
+    private func process(_ account:BatchAccount) async throws {
+        var starling = starlingService
+        starling.accountUid = account.accountUid
+        starling.customerName = account.customerName
+        let (snapshot, _) = try await retrying {
+            try await self.starlingPermits.withPermit { try await starling.fetchAccount() }
+        }
+        let content = starling.summary(for: promptCompactor.compact(snapshot, using: starling))
+        let summary = try await retrying {
+            try await self.chatgptPermits.withPermit { try await self.chatgptService.summarize(content: content) }
+        }
+        try await retrying {
+            try await self.deliveryPermits.withPermit { try await self.deliver(account, summary) }
+        }
+    }
+
+    private func retrying<T>(_ operation: () async throws -> T) async throws -> T {
+        var attempt = 0
+        while true {
+            do {
+                return try await operation()
+            } catch {
+                attempt += 1
+                if attempt >= retryPolicy.maxAttempts || !retryPolicy.shouldRetry(error) {
+                    throw error
+                }
+                // Full jitter keeps retries from many accounts from landing together.
+                let ceiling = min(retryPolicy.maxDelay, retryPolicy.baseDelay * pow(2, Double(attempt - 1)))
+                try await Task.sleep(for: .seconds(Double.random(in: 0...ceiling)))
+            }
+        }
+    }
+
+    private func loadCheckpoint() -> Set<String> {
+        guard let checkpointURL,
+              let data = try? Data(contentsOf: checkpointURL),
+              let completed = try? JSONDecoder().decode([String].self, from: data) else {
+            return []
+        }
+        return Set(completed)
+    }
+
+    private func saveCheckpoint(_ completed:Set<String>) {
+        guard let checkpointURL else { return }
+        do {
+            let data = try JSONEncoder().encode(completed.sorted())
+            try data.write(to: checkpointURL, options: .atomic)
+        } catch {
+            print("Failed to save batch checkpoint \(error.localizedDescription)")
+        }
+    }
+}
@@ -0,0 +1,216 @@
+//
+//  BufferedLogger.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import os
+import Synchronization
+import TwilioVoice
+import UIKit
+
+// TwilioVoice logger that keeps SDK logging off the call setup path. `log`
+// only copies the raw fields into a preallocated ring of fixed-size slots under
+// a short lock; timestamps, level names and lines are formatted later on a
+// background queue, `flushInterval` after the first entry since the last drain,
+// and when the app resigns active or terminates. Each flush appends one
+// zlib-compressed batch to the current file, which rotates at `maximumFileBytes`.
+// When the ring is full new entries are dropped and counted rather than
+// blocking the SDK thread.
+final class BufferedLogger:NSObject, TwilioVoice.Logger {
+
+    static let shared = BufferedLogger(directory: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appending(path: "voice-logs"))
+
+    struct Options {
+        var slots = 2048
+        var messageBytes = 472
+        var flushInterval = Duration.seconds(1)
+        var maximumFileBytes = 1 << 20
+        var maximumFiles = 5
+    }
+
+    let directory:URL
+    let options:Options
+
+    // Slot layout: time (Double), level (Int32), module (Int32), message length (Int32), padding, message bytes.
+    private static let slotHeader = 24
+    private let slotSize:Int
+    private let slots:UnsafeMutableRawPointer
+    // Indices grow monotonically and wrap through `% options.slots`. `scheduled`
+    // is set while a drain is pending, so an idle logger never wakes the app.
+    private let indices = OSAllocatedUnfairLock(initialState: (head: 0, tail: 0, scheduled: false))
+    private let droppedCount = Atomic<Int>(0)
+    private let truncatedCount = Atomic<Int>(0)
+    private let queue = DispatchQueue(label: "BufferedLogger", qos: .utility)
+    private var observers = [NSObjectProtocol]()
+    // The fields below are only touched on queue.
+    private var batch = Data()
+    private var reportedDrops = 0
+
+    private static let levelNames = ["OFF", "FATAL", "ERROR", "WARN", "INFO", "DEBUG", "TRACE", "ALL"]
+    private static let moduleNames = ["core", "platform", "signaling", "webrtc"]
+
+    init(directory:URL, options:Options = Options()) {
+        self.directory = directory
+        self.options = options
+        slotSize = BufferedLogger.slotHeader + options.messageBytes
+        slots = .allocate(byteCount: slotSize * options.slots, alignment: 8)
+        slots.initializeMemory(as: UInt8.self, repeating: 0, count: slotSize * options.slots)
+        super.init()
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        // Pending entries would be lost if the app were suspended or killed before the next drain.
+        for name in [UIApplication.willResignActiveNotification, UIApplication.willTerminateNotification] {
+            observers.append(NotificationCenter.default.addObserver(forName: name, object: nil, queue: nil) { [weak self] _ in
+                self?.flush()
+            })
+        }
+    }
+
+    deinit {
+        for observer in observers {
+            NotificationCenter.default.removeObserver(observer)
+        }
+        slots.deallocate()
+    }
+
+    var dropped:Int {
+        droppedCount.load(ordering: .relaxed)
+    }
+
+    var truncated:Int {
+        truncatedCount.load(ordering: .relaxed)
+    }
+
+    // MARK: Logger
+
+    func log(params: LogParameters) {
+        let time = Date().timeIntervalSince1970
+        let level = Int32(truncatingIfNeeded: Int(params.logLevel.rawValue))
+        let module = Int32(truncatingIfNeeded: Int(params.logModule.rawValue))
+        // Copied straight from the SDK's NSString, so a bridged message is never
+        // converted to a native String on the SDK thread.
+        let message = params.message as NSString
+        let schedule = indices.withLock { indices -> Bool in
+            guard indices.head - indices.tail < options.slots else {
+                _ = droppedCount.wrappingAdd(1, ordering: .relaxed)
+                return false
+            }
+            let slot = slots + (indices.head % options.slots) * slotSize
+            var length = 0
+            var remaining = NSRange()
+            message.getBytes(slot + BufferedLogger.slotHeader, maxLength: options.messageBytes, usedLength: &length,
+                             encoding: String.Encoding.utf8.rawValue, options: [],
+                             range: NSRange(location: 0, length: message.length), remaining: &remaining)
+            if remaining.length > 0 {
+                _ = truncatedCount.wrappingAdd(1, ordering: .relaxed)
+            }
+            slot.storeBytes(of: time, toByteOffset: 0, as: Double.self)
+            slot.storeBytes(of: level, toByteOffset: 8, as: Int32.self)
+            slot.storeBytes(of: module, toByteOffset: 12, as: Int32.self)
+            slot.storeBytes(of: Int32(length), toByteOffset: 16, as: Int32.self)
+            indices.head += 1
+            defer { indices.scheduled = true }
+            return !indices.scheduled
+        }
+        if schedule {
+            scheduleDrain()
+        }
+    }
+
+    // Formats and writes everything logged so far. Safe to call from any thread.
+    func flush() {
+        queue.sync {
+            drain()
+        }
+    }
+
+    // MARK: Draining
+
+    private func scheduleDrain() {
+        queue.asyncAfter(deadline: .now() + options.flushInterval.timeInterval) { [weak self] in
+            self?.drain()
+        }
+    }
+
+    private func drain() {
+        let (head, tail, _) = indices.withLock { $0 }
+        // Slots in tail..<head are complete and producers will not touch them until tail moves.
+        let formatter = ISO8601DateFormatter()
+        formatter.formatOptions = [.withInternetDateTime, .withFractionalSeconds]
+        for index in tail..<head {
+            let slot = slots + (index % options.slots) * slotSize
+            let time = slot.load(fromByteOffset: 0, as: Double.self)
+            let level = Int(slot.load(fromByteOffset: 8, as: Int32.self))
+            let module = Int(slot.load(fromByteOffset: 12, as: Int32.self))
+            let length = Int(slot.load(fromByteOffset: 16, as: Int32.self))
+            let message = String(decoding: UnsafeRawBufferPointer(start: slot + BufferedLogger.slotHeader, count: length), as: UTF8.self)
+            let levelName = BufferedLogger.levelNames.indices.contains(level) ? BufferedLogger.levelNames[level] : "\(level)"
+            let moduleName = BufferedLogger.moduleNames.indices.contains(module) ? BufferedLogger.moduleNames[module] : "\(module)"
+            batch.append(contentsOf: "\(formatter.string(from: Date(timeIntervalSince1970: time))) \(levelName) [\(moduleName)] \(message)\n".utf8)
+        }
+        // Entries logged while formatting need another drain; otherwise go idle.
+        let pending = indices.withLock { indices -> Bool in
+            indices.tail = head
+            indices.scheduled = indices.head > head
+            return indices.scheduled
+        }
+        if pending {
+            scheduleDrain()
+        }
+        let drops = dropped
+        if drops > reportedDrops {
+            batch.append(contentsOf: "\(formatter.string(from: Date())) WARN [logger] dropped \(drops - reportedDrops) entries, ring full\n".utf8)
+            reportedDrops = drops
+        }
+        guard !batch.isEmpty else { return }
+        writeBatch()
+        batch.removeAll(keepingCapacity: true)
+    }
+
+    // File layout: repeated [UInt32 little-endian length][zlib-compressed lines].
+    private func writeBatch() {
+        do {
+            let compressed = try (batch as NSData).compressed(using: .zlib) as Data
+            let url = directory.appending(path: "voice.0.log.z")
+            rotateIfNeeded(adding: compressed.count + 4, to: url)
+            if !FileManager.default.fileExists(atPath: url.path) {
+                FileManager.default.createFile(atPath: url.path, contents: nil)
+            }
+            let handle = try FileHandle(forWritingTo: url)
+            defer { try? handle.close() }
+            try handle.seekToEnd()
+            try handle.write(contentsOf: withUnsafeBytes(of: UInt32(compressed.count).littleEndian) { Data($0) })
+            try handle.write(contentsOf: compressed)
+        } catch {
+            print("Failed to write voice log batch \(error.localizedDescription)")
+        }
+    }
+
+    private func rotateIfNeeded(adding bytes:Int, to url:URL) {
+        let size = (try? FileManager.default.attributesOfItem(atPath: url.path)[.size] as? Int) ?? 0
+        guard size > 0, size + bytes > options.maximumFileBytes else { return }
+        let fileManager = FileManager.default
+        try? fileManager.removeItem(at: directory.appending(path: "voice.\(options.maximumFiles - 1).log.z"))
+        for index in stride(from: options.maximumFiles - 2, through: 0, by: -1) {
+            try? fileManager.moveItem(at: directory.appending(path: "voice.\(index).log.z"),
+                                      to: directory.appending(path: "voice.\(index + 1).log.z"))
+        }
+    }
+
+    // Reads a rotated file back into text, for attaching logs to bug reports.
+    static func decode(_ url:URL) throws -> String {
+        let data = try Data(contentsOf: url)
+        var text = ""
+        var offset = data.startIndex
+        while offset + 4 <= data.endIndex {
+            let length = Int(UInt32(littleEndian: data[offset..<offset + 4].withUnsafeBytes { $0.loadUnaligned(as: UInt32.self) }))
+            offset += 4
+            guard offset + length <= data.endIndex else { throw CocoaError(.fileReadCorruptFile) }
+            let lines = try (data[offset..<offset + length] as NSData).decompressed(using: .zlib) as Data
+            text += String(decoding: lines, as: UTF8.self)
+            offset += length
+        }
+        return text
+    }
+}
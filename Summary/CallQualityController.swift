@@ -0,0 +1,181 @@
+//
+//  CallQualityController.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import TwilioVoice
+
+// One poll of Call.getStats, reduced to what the bitrate policy needs.
+// Packet counters are cumulative for the call, as the SDK reports them.
+struct CallQualitySample:Codable {
+    var time:TimeInterval
+    var availableOutgoingBitrate:Double
+    var roundTripTime:TimeInterval
+    var packetsSent:Int
+    var packetsLost:Int
+}
+
+// Picks the Opus bitrate for the next call from a recorded stats trace. Pure and
+// deterministic, so recorded traces can be replayed against it offline.
+struct OpusBitratePolicy {
+
+    struct Tier {
+        var bitrate:Int
+        var minimumAvailableBitrate:Double
+        var maximumLoss:Double
+        var maximumRoundTripTime:TimeInterval
+    }
+
+    // Best first. The last tier has no limits and is the floor on bad networks:
+    // low-bitrate Opus keeps the call up where PCMU's fixed 64 kbps would not.
+    var tiers = [
+        Tier(bitrate: 40_000, minimumAvailableBitrate: 96_000, maximumLoss: 0.02, maximumRoundTripTime: 0.25),
+        Tier(bitrate: 24_000, minimumAvailableBitrate: 48_000, maximumLoss: 0.05, maximumRoundTripTime: 0.4),
+        Tier(bitrate: 16_000, minimumAvailableBitrate: 24_000, maximumLoss: 0.10, maximumRoundTripTime: 0.6),
+        Tier(bitrate: 8_000, minimumAvailableBitrate: 0, maximumLoss: 1, maximumRoundTripTime: .infinity)
+    ]
+    // Only the most recent samples describe the network the next call will see.
+    var window = 10
+
+    func decide(trace:[CallQualitySample], previousBitrate:Int?) -> Int {
+        let recent = trace.suffix(window)
+        guard let first = recent.first, let last = recent.last else {
+            return previousBitrate ?? tiers[0].bitrate
+        }
+        let sent = last.packetsSent - first.packetsSent
+        let lost = last.packetsLost - first.packetsLost
+        let loss = sent + lost > 0 ? Double(max(0, lost)) / Double(sent + lost) : 0
+        // Medians, so one bad poll does not drive the decision.
+        let available = median(recent.map(\.availableOutgoingBitrate))
+        let roundTripTime = median(recent.map(\.roundTripTime))
+        let measured = tiers.firstIndex {
+            available >= $0.minimumAvailableBitrate && loss <= $0.maximumLoss && roundTripTime <= $0.maximumRoundTripTime
+        } ?? tiers.count - 1
+        // Drop straight to the measured tier, but only climb one tier per call.
+        guard let previousBitrate, let previous = tiers.firstIndex(where: { $0.bitrate <= previousBitrate }) else {
+            return tiers[measured].bitrate
+        }
+        return tiers[measured < previous ? previous - 1 : measured].bitrate
+    }
+
+    private func median(_ values:[Double]) -> Double {
+        let sorted = values.sorted()
+        return sorted[sorted.count / 2]
+    }
+}
+
+// Polls Call.getStats while a call is up, records the trace and the call's
+// CallStatsStore history, and when the call ends stores the policy's bitrate
+// for the next call or reconnect.
+final class CallQualityController {
+
+    static let shared = CallQualityController()
+
+    var policy = OpusBitratePolicy()
+    var pollInterval = Duration.seconds(2)
+    private let defaults:UserDefaults
+    private let queue = DispatchQueue(label: "CallQualityController")
+    // The fields below are only touched on queue.
+    private var trace = [CallQualitySample]()
+    private var history = CallStatsStore()
+    private var callSid = ""
+    private var timer:DispatchSourceTimer?
+    private var startTime = Date()
+
+    private static let bitrateKey = "CallQualityController.opusMaxAverageBitrate"
+
+    init(defaults:UserDefaults = .standard) {
+        self.defaults = defaults
+    }
+
+    var nextBitrate:Int? {
+        let bitrate = defaults.integer(forKey: CallQualityController.bitrateKey)
+        return bitrate > 0 ? bitrate : nil
+    }
+
+    // Opus at the chosen bitrate first, PCMU as the fallback if the far end cannot do Opus.
+    // `ceiling`, e.g. a preflight's bitrate for this network, caps what past calls chose.
+    func preferredAudioCodecs(ceiling:Int? = nil) -> [AudioCodec] {
+        let bitrate = nextBitrate ?? policy.tiers[0].bitrate
+        return [OpusCodec(maxAverageBitrate: min(bitrate, ceiling ?? bitrate)), PcmuCodec()]
+    }
+
+    func start(call:Call) {
+        queue.sync {
+            trace.removeAll()
+            history = CallStatsStore()
+            callSid = call.sid
+            startTime = Date()
+            let timer = DispatchSource.makeTimerSource(queue: queue)
+            timer.schedule(deadline: .now() + pollInterval.timeInterval, repeating: pollInterval.timeInterval)
+            timer.setEventHandler { [weak self, weak call] in
+                call?.getStats { reports in
+                    self?.record(reports)
+                }
+            }
+            self.timer = timer
+            timer.resume()
+        }
+    }
+
+    func stop() {
+        queue.sync {
+            timer?.cancel()
+            timer = nil
+            guard !trace.isEmpty else { return }
+            let bitrate = policy.decide(trace: trace, previousBitrate: nextBitrate)
+            defaults.set(bitrate, forKey: CallQualityController.bitrateKey)
+            print("Next call Opus bitrate \(bitrate) from \(trace.count) stats samples")
+            let roundTripTimes = trace.map(\.roundTripTime).sorted()
+            IceConfigurationManager.shared.recordCall(roundTripTime: roundTripTimes[roundTripTimes.count / 2])
+            for column in [CallStatsStore.Column.jitter, .roundTripTime, .mos] {
+                if let summary = history.summary(of: column) {
+                    print("Call \(column) min \(summary.minimum) avg \(String(format: "%.1f", summary.average)) max \(summary.maximum)")
+                }
+            }
+            JitterBufferTuner.shared.record(history)
+            saveTrace()
+        }
+    }
+
+    static func sample(from reports:[StatsReport], time:TimeInterval) -> CallQualitySample? {
+        guard let report = reports.first else { return nil }
+        let pair = report.iceCandidatePairStats.first { $0.isActiveCandidatePair } ?? report.iceCandidatePairStats.first
+        guard let pair, let audio = report.localAudioTrackStats.first else { return nil }
+        return CallQualitySample(time: time,
+                                 availableOutgoingBitrate: pair.availableOutgoingBitrate,
+                                 roundTripTime: pair.currentRoundTripTime,
+                                 packetsSent: Int(audio.packetsSent),
+                                 packetsLost: Int(audio.packetsLost))
+    }
+
+    private func record(_ reports:[StatsReport]) {
+        queue.async { [self] in
+            guard timer != nil else { return }
+            let time = Date().timeIntervalSince(startTime)
+            history.append(reports, time: time)
+            if let sample = CallQualityController.sample(from: reports, time: time) {
+                trace.append(sample)
+            }
+        }
+    }
+
+    // Keeps the last trace on disk so policy changes can be replayed against real calls.
+    private func saveTrace() {
+        let url = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appending(path: "call-quality-trace.json")
+        do {
+            try JSONEncoder().encode(trace).write(to: url, options: .atomic)
+        } catch {
+            print("Failed to save call quality trace \(error.localizedDescription)")
+        }
+        let directory = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appending(path: "call-stats")
+        do {
+            try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+            try history.write(to: directory.appending(path: "\(callSid).stats"))
+        } catch {
+            print("Failed to save call stats history \(error.localizedDescription)")
+        }
+    }
+}
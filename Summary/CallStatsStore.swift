@@ -0,0 +1,222 @@
+//
+//  CallStatsStore.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import TwilioVoice
+
+// Per-call quality history in columnar form. Each StatsReport is flattened into
+// one row of fixed-width Int32 columns, stored in preallocated chunks, so a poll
+// allocates nothing after the first row of a chunk. Queries run over whole
+// columns with SIMD, and files store each column delta+zigzag varint encoded.
+final class CallStatsStore {
+
+    enum Column:Int, CaseIterable {
+        case time           // ms since the call connected
+        case jitter         // ms, remote audio
+        case mos            // mean opinion score x 1000, remote audio
+        case roundTripTime  // ms, local audio
+        case packetsLost    // cumulative, remote audio
+        case bytesSent      // cumulative
+        case bytesReceived  // cumulative
+    }
+
+    struct Summary {
+        var minimum:Int32
+        var average:Double
+        var maximum:Int32
+    }
+
+    static let chunkRows = 256
+    private static let magic:UInt32 = 0x5453_4353 // "SCST"
+    private static let version:UInt8 = 1
+
+    private final class Chunk {
+        let storage:UnsafeMutablePointer<Int32>
+        var rows = 0
+
+        init() {
+            let count = CallStatsStore.chunkRows * Column.allCases.count
+            storage = .allocate(capacity: count)
+            storage.initialize(repeating: 0, count: count)
+        }
+
+        deinit {
+            storage.deallocate()
+        }
+
+        func column(_ column:Column) -> UnsafeMutablePointer<Int32> {
+            storage + column.rawValue * CallStatsStore.chunkRows
+        }
+    }
+
+    private var chunks = [Chunk]()
+
+    var count:Int {
+        chunks.reduce(0) { $0 + $1.rows }
+    }
+
+    // Values in Column order.
+    func append(_ row:[Int32]) {
+        precondition(row.count == Column.allCases.count, "One value per column")
+        appendRow { row[$0.rawValue] }
+    }
+
+    // Flattens the first report straight into a row; nothing from the report is retained.
+    func append(_ reports:[StatsReport], time:TimeInterval) {
+        guard let report = reports.first else { return }
+        let local = report.localAudioTrackStats.first
+        let remote = report.remoteAudioTrackStats.first
+        func clamp<T:BinaryInteger>(_ value:T?) -> Int32 {
+            Int32(clamping: value ?? 0)
+        }
+        appendRow { column in
+            switch column {
+            case .time: Int32(clamping: Int(time * 1000))
+            case .jitter: clamp(remote?.jitter)
+            case .mos: Int32(clamping: Int((remote?.mos ?? 0) * 1000))
+            case .roundTripTime: clamp(local?.roundTripTime)
+            case .packetsLost: clamp(remote?.packetsLost)
+            case .bytesSent: clamp(local?.bytesSent)
+            case .bytesReceived: clamp(remote?.bytesReceived)
+            }
+        }
+    }
+
+    private func appendRow(_ value:(Column) -> Int32) {
+        if chunks.last.map({ $0.rows == CallStatsStore.chunkRows }) ?? true {
+            chunks.append(Chunk())
+        }
+        let chunk = chunks[chunks.count - 1]
+        for column in Column.allCases {
+            chunk.column(column)[chunk.rows] = value(column)
+        }
+        chunk.rows += 1
+    }
+
+    func value(_ column:Column, at row:Int) -> Int32 {
+        chunks[row / CallStatsStore.chunkRows].column(column)[row % CallStatsStore.chunkRows]
+    }
+
+    // Min, mean and max of a column, eight rows per SIMD step.
+    func summary(of column:Column) -> Summary? {
+        guard count > 0 else { return nil }
+        var lowest = SIMD8<Int32>(repeating: .max)
+        var highest = SIMD8<Int32>(repeating: .min)
+        var sums = SIMD8<Int64>()
+        var scalarLowest = Int32.max
+        var scalarHighest = Int32.min
+        var scalarSum:Int64 = 0
+        for chunk in chunks {
+            let values = chunk.column(column)
+            var row = 0
+            while row + 8 <= chunk.rows {
+                let vector = UnsafeRawPointer(values + row).loadUnaligned(as: SIMD8<Int32>.self)
+                lowest = pointwiseMin(lowest, vector)
+                highest = pointwiseMax(highest, vector)
+                sums &+= SIMD8<Int64>(truncatingIfNeeded: vector)
+                row += 8
+            }
+            while row < chunk.rows {
+                scalarLowest = min(scalarLowest, values[row])
+                scalarHighest = max(scalarHighest, values[row])
+                scalarSum += Int64(values[row])
+                row += 1
+            }
+        }
+        return Summary(minimum: min(lowest.min(), scalarLowest),
+                       average: Double(sums.wrappedSum() + scalarSum) / Double(count),
+                       maximum: max(highest.max(), scalarHighest))
+    }
+
+    // MARK: Persistence
+
+    // Layout: magic, version, row count, then each column as zigzag varints of
+    // the difference from the previous row. Cumulative counters and timestamps
+    // shrink to one or two bytes per row.
+    func encoded() -> Data {
+        var data = Data()
+        data.reserveCapacity(16 + count * Column.allCases.count * 2)
+        withUnsafeBytes(of: CallStatsStore.magic.littleEndian) { data.append(contentsOf: $0) }
+        data.append(CallStatsStore.version)
+        CallStatsStore.appendVarint(UInt64(count), to: &data)
+        for column in Column.allCases {
+            var previous:Int64 = 0
+            for chunk in chunks {
+                let values = chunk.column(column)
+                for row in 0..<chunk.rows {
+                    let value = Int64(values[row])
+                    let delta = value - previous
+                    CallStatsStore.appendVarint(UInt64(bitPattern: (delta << 1) ^ (delta >> 63)), to: &data)
+                    previous = value
+                }
+            }
+        }
+        return data
+    }
+
+    convenience init(data:Data) throws {
+        self.init()
+        guard data.count >= 5,
+              data.prefix(4).withUnsafeBytes({ $0.loadUnaligned(as: UInt32.self) }) == CallStatsStore.magic.littleEndian,
+              data[data.startIndex + 4] == CallStatsStore.version else {
+            throw CocoaError(.fileReadCorruptFile)
+        }
+        var reader = VarintReader(data: data, offset: 5)
+        let rows = Int(try reader.next())
+        // Every value takes at least one byte, which bounds a corrupt row count.
+        guard rows <= data.count else { throw CocoaError(.fileReadCorruptFile) }
+        var columns = [[Int32]]()
+        for _ in Column.allCases {
+            var values = [Int32]()
+            values.reserveCapacity(rows)
+            var previous:Int64 = 0
+            for _ in 0..<rows {
+                let zigzag = try reader.next()
+                let delta = Int64(bitPattern: zigzag >> 1) ^ -Int64(bitPattern: zigzag & 1)
+                previous += delta
+                values.append(Int32(truncatingIfNeeded: previous))
+            }
+            columns.append(values)
+        }
+        for row in 0..<rows {
+            appendRow { columns[$0.rawValue][row] }
+        }
+    }
+
+    func write(to url:URL) throws {
+        try encoded().write(to: url, options: .atomic)
+    }
+
+    private static func appendVarint(_ value:UInt64, to data:inout Data) {
+        var value = value
+        while value >= 0x80 {
+            data.append(UInt8(truncatingIfNeeded: value) | 0x80)
+            value >>= 7
+        }
+        data.append(UInt8(value))
+    }
+
+    private struct VarintReader {
+        let data:Data
+        var offset = 0
+
+        mutating func next() throws -> UInt64 {
+            var value:UInt64 = 0
+            var shift:UInt64 = 0
+            while offset < data.count {
+                let byte = data[data.startIndex + offset]
+                offset += 1
+                value |= UInt64(byte & 0x7F) << shift
+                if byte & 0x80 == 0 {
+                    return value
+                }
+                shift += 7
+                guard shift < 64 else { break }
+            }
+            throw CocoaError(.fileReadCorruptFile)
+        }
+    }
+}
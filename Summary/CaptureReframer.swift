@@ -0,0 +1,115 @@
+//
+//  CaptureReframer.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+// Turns source chunks of any size (TTS buffers, file decoder output) into the
+// fixed `framesPerBuffer` chunks AudioDeviceWriteCaptureData expects. Sources are
+// queued as views, not copied. A buffer that lies inside one source chunk is
+// handed out in place. Only a buffer that straddles two chunks is gathered into
+// the staging buffer. Not thread-safe; use it from the capturer's queue.
+final class CaptureReframer {
+
+    private struct Segment {
+        var base:UnsafePointer<Int16>
+        var count:Int
+        // Keeps the memory behind `base` alive until the segment is consumed.
+        var owner:AnyObject?
+    }
+
+    let samplesPerBuffer:Int
+    private(set) var queuedSamples = 0
+    // Bytes gathered into staging, to measure how much copying reframing costs.
+    private(set) var copiedBytes = 0
+    private var segments = [Segment]()
+    private var head = 0
+    private var offset = 0
+    private let staging:UnsafeMutablePointer<Int16>
+
+    init(framesPerBuffer:Int, channels:Int) {
+        samplesPerBuffer = framesPerBuffer * channels
+        staging = .allocate(capacity: samplesPerBuffer)
+        staging.initialize(repeating: 0, count: samplesPerBuffer)
+    }
+
+    deinit {
+        staging.deallocate()
+    }
+
+    // Queues a view over `count` samples. `owner` must keep them alive and unchanged until they are emitted.
+    func append(_ base:UnsafePointer<Int16>, count:Int, owner:AnyObject?) {
+        guard count > 0 else { return }
+        segments.append(Segment(base: base, count: count, owner: owner))
+        queuedSamples += count
+    }
+
+    // Calls `body` with one whole buffer and returns true, or returns false when
+    // less than a buffer is queued. The pointer is only valid inside `body`.
+    @discardableResult
+    func emit(_ body:(UnsafePointer<Int16>) -> Void) -> Bool {
+        guard queuedSamples >= samplesPerBuffer else { return false }
+        let segment = segments[head]
+        if segment.count - offset >= samplesPerBuffer {
+            body(segment.base + offset)
+            consume(samplesPerBuffer)
+            return true
+        }
+        gather(samplesPerBuffer)
+        body(staging)
+        return true
+    }
+
+    // Emits what is left as a final buffer padded with silence. Returns false when nothing is queued.
+    @discardableResult
+    func emitRemainder(_ body:(UnsafePointer<Int16>) -> Void) -> Bool {
+        guard queuedSamples > 0 else { return false }
+        if emit(body) {
+            return true
+        }
+        let remaining = queuedSamples
+        gather(remaining)
+        (staging + remaining).update(repeating: 0, count: samplesPerBuffer - remaining)
+        body(staging)
+        return true
+    }
+
+    func reset() {
+        segments.removeAll(keepingCapacity: true)
+        head = 0
+        offset = 0
+        queuedSamples = 0
+    }
+
+    private func gather(_ count:Int) {
+        var filled = 0
+        while filled < count {
+            let segment = segments[head]
+            let take = min(count - filled, segment.count - offset)
+            (staging + filled).update(from: segment.base + offset, count: take)
+            filled += take
+            consume(take)
+        }
+        copiedBytes += count * MemoryLayout<Int16>.size
+    }
+
+    private func consume(_ count:Int) {
+        offset += count
+        queuedSamples -= count
+        if offset == segments[head].count {
+            segments[head].owner = nil
+            head += 1
+            offset = 0
+            // Drop consumed segments in batches rather than shifting on every buffer.
+            if head == segments.count {
+                segments.removeAll(keepingCapacity: true)
+                head = 0
+            } else if head >= 64 {
+                segments.removeFirst(head)
+                head = 0
+            }
+        }
+    }
+}
@@ -5,24 +5,81 @@
 //  Created by Kouv on 25/02/2025.
 //
 import Foundation
-import Combine
 
 struct ChatGPTService {
-    
-    func getSummary(content:String) -> AnyPublisher<ChatResponse,Error> {
-        let system = ["role":"system","content":"You will be provided with banking information. You need to create a nice polite paragraph summarising all information to the customer.Finish with any assistance required contact us and wish you a awesome day. Remove yours truly in the end"]
+
+    static let model = "gpt-4o-mini"
+    static let systemPrompt = "You will be provided with banking information. You need to create a nice polite paragraph summarising all information to the customer.Finish with any assistance required contact us and wish you a awesome day. Remove yours truly in the end"
+
+    var session = NetworkClient.shared.session
+
+    func summarize(content:String) async throws -> String {
+        let (data,response) = try await session.data(for: makeRequest(content: content, stream: false))
+        if let httpResponse = response as? HTTPURLResponse, httpResponse.statusCode != 200 {
+            throw HTTPStatusError(statusCode: httpResponse.statusCode)
+        }
+        let chatResponse = try JSONDecoder().decode(ChatResponse.self, from: data)
+        guard let choice = chatResponse.choices.first else {
+            throw URLError(.cannotParseResponse)
+        }
+        return choice.message.content
+    }
+
+    // Streams the completion as server-sent events, yielding each content delta as soon as it arrives.
+    func streamSummary(content:String) -> AsyncThrowingStream<String,Error> {
+        let urlRequest = makeRequest(content: content, stream: true)
+        return AsyncThrowingStream { continuation in
+            let task = Task {
+                do {
+                    let (bytes, response) = try await session.bytes(for: urlRequest)
+                    if let httpResponse = response as? HTTPURLResponse, httpResponse.statusCode != 200 {
+                        throw HTTPStatusError(statusCode: httpResponse.statusCode)
+                    }
+                    var parser = SSEParser()
+                    for try await byte in bytes {
+                        guard let event = parser.consume(byte) else { continue }
+                        if try !yieldDelta(event, to: continuation) {
+                            break
+                        }
+                    }
+                    if let event = parser.finish() {
+                        _ = try yieldDelta(event, to: continuation)
+                    }
+                    continuation.finish()
+                } catch {
+                    continuation.finish(throwing: error)
+                }
+            }
+            continuation.onTermination = { _ in
+                task.cancel()
+            }
+        }
+    }
+
+    // Returns false once the terminating [DONE] event has been seen.
+    private func yieldDelta(_ event: SSEEvent, to continuation: AsyncThrowingStream<String,Error>.Continuation) throws -> Bool {
+        if event.data == "[DONE]" {
+            return false
+        }
+        let chunk = try JSONDecoder().decode(ChatStreamChunk.self, from: Data(event.data.utf8))
+        if let content = chunk.choices.first?.delta.content, !content.isEmpty {
+            continuation.yield(content)
+        }
+        return true
+    }
+
+    private func makeRequest(content:String, stream:Bool) -> URLRequest {
+        let system = ["role":"system","content":ChatGPTService.systemPrompt]
         let user = ["role":"user","content":content]
-        let params:[String:Any] = ["model":"gpt-4o-mini","messages":[system,user],"store":true]
+        let params:[String:Any] = ["model":ChatGPTService.model,"messages":[system,user],"store":true,"stream":stream]
         var urlRequest = URLRequest(url: URL(string: "https://api.openai.com/v1/chat/completions")!)
         urlRequest.httpMethod = "POST"
         urlRequest.setValue("application/json", forHTTPHeaderField: "Content-Type")
+        if stream {
+            urlRequest.setValue("text/event-stream", forHTTPHeaderField: "Accept")
+        }
         urlRequest.setValue("Bearer <ACCESS TOKEN>", forHTTPHeaderField: "Authorization")
         urlRequest.httpBody = try? JSONSerialization.data(withJSONObject: params)
-        
-       return  URLSession.shared.dataTaskPublisher(for: urlRequest)
-            .map(\.data)
-            .decode(type: ChatResponse.self, decoder: JSONDecoder())
-            .eraseToAnyPublisher()
-        
+        return urlRequest
     }
 }
@@ -30,10 +30,10 @@ struct ContentView: View {
                             Task {
                                 showLoading = true
                                 do {
-                                    try await viewModel.getSummary() {_ in
+                                    try await viewModel.getSummary() { fetched in
                                         showLoading = false
-                                        hideFetchButton = true
-                                        showCallButton = true
+                                        hideFetchButton = fetched
+                                        showCallButton = fetched
                                     }
                                 } catch {
                                     print("Failed to fetch account info \(error.localizedDescription)")
@@ -59,6 +59,14 @@ struct ContentView: View {
                 
                 }
                
+                if viewModel.isCalling {
+                    TimelineView(.animation(minimumInterval: 1.0 / 60)) { _ in
+                        let level = viewModel.captureLevel
+                        ProgressView(value: Double(level.rms), total: 1)
+                            .tint(level.peak > 0.9 ? .red : .purple)
+                            .padding(.horizontal)
+                    }
+                }
                 Spacer()
             }
             .padding()
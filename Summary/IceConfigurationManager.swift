@@ -0,0 +1,154 @@
+//
+//  IceConfigurationManager.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import os
+import TwilioVoice
+
+// Latency history for one transport policy, smoothed so one slow connect does not flip the decision.
+struct IceTransportMeasurement:Codable {
+    var connectMilliseconds:Double?
+    var roundTripMilliseconds:Double?
+    var samples = 0
+}
+
+// Pure relay decisions over recorded measurements.
+struct IceTransportPolicyRule {
+
+    var smoothing = 0.3
+    // Consecutive connections whose direct candidates failed before they are given up on.
+    var relayAfterDirectFailures = 3
+    // A direct ICE connect slower than this spent its time on checks that went nowhere.
+    var slowConnectMilliseconds = 2_500.0
+    // How long relay-only sticks before direct candidates are tried again.
+    var relayRetryInterval = Duration.seconds(60 * 60)
+
+    func updated(_ measurement:IceTransportMeasurement, connectMilliseconds:Double?, roundTripMilliseconds:Double?) -> IceTransportMeasurement {
+        var measurement = measurement
+        func blend(_ old:Double?, _ new:Double?) -> Double? {
+            guard let new else { return old }
+            guard let old else { return new }
+            return old + smoothing * (new - old)
+        }
+        measurement.connectMilliseconds = blend(measurement.connectMilliseconds, connectMilliseconds)
+        measurement.roundTripMilliseconds = blend(measurement.roundTripMilliseconds, roundTripMilliseconds)
+        measurement.samples += 1
+        return measurement
+    }
+
+    func directFailed(_ preflight:PreflightRecord) -> Bool {
+        preflight.failed || preflight.isTurnRequired || (preflight.iceConnectionMilliseconds ?? 0) > slowConnectMilliseconds
+    }
+
+    // Relay while direct keeps failing. When relay has also measured at least
+    // as fast as direct, direct is retried four times less often.
+    func useRelay(directFailures:Int, relaySince:Date?, direct:IceTransportMeasurement, relay:IceTransportMeasurement, now:Date) -> Bool {
+        guard directFailures >= relayAfterDirectFailures, let relaySince else { return false }
+        var retryInterval = relayRetryInterval
+        if let directRoundTrip = direct.roundTripMilliseconds, let relayRoundTrip = relay.roundTripMilliseconds, relayRoundTrip <= directRoundTrip {
+            retryInterval *= 4
+        }
+        return now.timeIntervalSince(relaySince) < retryInterval.timeInterval
+    }
+}
+
+// Chooses the ICE transport policy for each connection from measured connect
+// times and round trips. The server list is left to the SDK, whose defaults
+// come with TURN credentials from the access token; ICE gathers from all of
+// them at once, so only the transport policy changes which path is used.
+final class IceConfigurationManager {
+
+    static let shared = IceConfigurationManager()
+
+    private struct State:Codable {
+        var direct = IceTransportMeasurement()
+        var relay = IceTransportMeasurement()
+        var directFailures = 0
+        var relaySince:Date?
+        // What the pending connection was given, so its results land on the right transport.
+        var relayAttempt = false
+    }
+
+    var rule = IceTransportPolicyRule()
+    private let defaults:UserDefaults
+    private let state:OSAllocatedUnfairLock<State>
+
+    private static let defaultsKey = "IceConfigurationManager.state"
+
+    init(defaults:UserDefaults = .standard) {
+        self.defaults = defaults
+        let stored = defaults.data(forKey: IceConfigurationManager.defaultsKey).flatMap { try? JSONDecoder().decode(State.self, from: $0) }
+        state = OSAllocatedUnfairLock(initialState: stored ?? State())
+    }
+
+    // Options for the next connection. Remembers the policy so the measurements
+    // that follow are credited to it.
+    func iceOptions(forceRelay:Bool = false, now:Date = Date()) -> IceOptions {
+        let relay = state.withLock { state in
+            state.relayAttempt = forceRelay || rule.useRelay(directFailures: state.directFailures, relaySince: state.relaySince,
+                                                             direct: state.direct, relay: state.relay, now: now)
+            return state.relayAttempt
+        }
+        return IceOptions { builder in
+            builder.transportPolicy = relay ? .relay : .all
+        }
+    }
+
+    func record(_ preflight:PreflightRecord) {
+        update { state in
+            if let connect = preflight.iceConnectionMilliseconds {
+                measure(&state, connectMilliseconds: connect, roundTripMilliseconds: preflight.roundTripTime)
+            }
+            recordDirect(failed: rule.directFailed(preflight), in: &state)
+        }
+    }
+
+    // Median currentRoundTripTime of the active candidate pair over a call, in seconds.
+    func recordCall(roundTripTime:TimeInterval) {
+        update { state in
+            measure(&state, connectMilliseconds: nil, roundTripMilliseconds: roundTripTime * 1000)
+        }
+    }
+
+    func recordConnectFailure() {
+        update { state in
+            recordDirect(failed: true, in: &state)
+        }
+    }
+
+    private func measure(_ state:inout State, connectMilliseconds:Double?, roundTripMilliseconds:Double?) {
+        if state.relayAttempt {
+            state.relay = rule.updated(state.relay, connectMilliseconds: connectMilliseconds, roundTripMilliseconds: roundTripMilliseconds)
+        } else {
+            state.direct = rule.updated(state.direct, connectMilliseconds: connectMilliseconds, roundTripMilliseconds: roundTripMilliseconds)
+        }
+    }
+
+    // Only connections that were allowed direct candidates say anything about them.
+    private func recordDirect(failed:Bool, in state:inout State) {
+        guard !state.relayAttempt else { return }
+        if failed {
+            state.directFailures += 1
+            // Each further failure after a retry window restarts relay-only.
+            if state.directFailures >= rule.relayAfterDirectFailures {
+                state.relaySince = Date()
+            }
+        } else {
+            state.directFailures = 0
+            state.relaySince = nil
+        }
+    }
+
+    private func update(_ body:(inout State) -> Void) {
+        let snapshot = state.withLock { state in
+            body(&state)
+            return state
+        }
+        if let data = try? JSONEncoder().encode(snapshot) {
+            defaults.set(data, forKey: IceConfigurationManager.defaultsKey)
+        }
+    }
+}
@@ -0,0 +1,146 @@
+//
+//  JitterBufferTuner.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import os
+import TwilioVoice
+
+struct JitterBufferSettings:Codable, Equatable {
+    var minimumDelayMilliseconds:Int
+    var maximumPackets:Int
+}
+
+// One finished call, reduced from its CallStatsStore history, with the settings it ran with.
+struct JitterCallRecord:Codable {
+    var jitterMedian:Double         // ms, remote audio
+    var jitterPeak:Double           // ms, 95th percentile
+    var mos:Double                  // median
+    var settings:JitterBufferSettings?
+
+    init(jitterMedian:Double, jitterPeak:Double, mos:Double, settings:JitterBufferSettings?) {
+        self.jitterMedian = jitterMedian
+        self.jitterPeak = jitterPeak
+        self.mos = mos
+        self.settings = settings
+    }
+
+    init?(history:CallStatsStore, settings:JitterBufferSettings?) {
+        guard history.count > 0 else { return nil }
+        let jitter = (0..<history.count).map { history.value(.jitter, at: $0) }.sorted()
+        // Polls before audio flows report a MOS of zero.
+        let mos = (0..<history.count).map { history.value(.mos, at: $0) }.filter { $0 > 0 }.sorted()
+        guard !mos.isEmpty else { return nil }
+        self.init(jitterMedian: Double(jitter[jitter.count / 2]),
+                  jitterPeak: Double(jitter[min(jitter.count - 1, jitter.count * 95 / 100)]),
+                  mos: Double(mos[mos.count / 2]) / 1000,
+                  settings: settings)
+    }
+}
+
+// Picks jitter buffer settings from a network class's recent calls. Pure and
+// deterministic, so recorded histories can be replayed against it offline.
+struct JitterBufferPolicy {
+
+    var window = 10
+    var packetMilliseconds = 20
+    var delayStep = 20
+    var maximumDelay = 200
+    var packetRange = 25...200
+    // Below this MOS the far end heard concealment, so buy more buffering.
+    var poorMos = 3.6
+
+    // nil leaves the SDK defaults, which is right until a network has history.
+    func decide(history:[JitterCallRecord]) -> JitterBufferSettings? {
+        let recent = history.suffix(window)
+        guard !recent.isEmpty else { return nil }
+        let typical = median(recent.map(\.jitterMedian))
+        let peak = median(recent.map(\.jitterPeak))
+        // Enough delay to ride out typical peaks without paying for the worst one.
+        var delay = roundUp(max(2 * typical, peak))
+        let previous = recent.last?.settings?.minimumDelayMilliseconds
+        if median(recent.map(\.mos)) < poorMos {
+            // Artifacts despite the delay we used: step past it.
+            let used = recent.filter { $0.mos < poorMos }.compactMap { $0.settings?.minimumDelayMilliseconds }.max() ?? 0
+            delay = max(delay, used + delayStep)
+        } else if let previous, delay < previous {
+            // Good calls: give latency back one step per call.
+            delay = max(delay, previous - delayStep)
+        }
+        delay = min(max(delay, 0), maximumDelay)
+        // Room for the delay plus a few peaks' worth of bursty arrivals.
+        let packets = (delay + Int((3 * peak).rounded(.up)) + packetMilliseconds - 1) / packetMilliseconds
+        return JitterBufferSettings(minimumDelayMilliseconds: delay,
+                                    maximumPackets: min(max(packets, packetRange.lowerBound), packetRange.upperBound))
+    }
+
+    private func roundUp(_ milliseconds:Double) -> Int {
+        Int((milliseconds / 10).rounded(.up)) * 10
+    }
+
+    private func median(_ values:[Double]) -> Double {
+        let sorted = values.sorted()
+        return sorted[sorted.count / 2]
+    }
+}
+
+// Remembers recent calls per network class (PreflightService's network
+// identity) and hands the policy's settings to the next call on that network.
+final class JitterBufferTuner {
+
+    static let shared = JitterBufferTuner()
+
+    private struct State:Codable {
+        var history = [String:[JitterCallRecord]]()
+        // What the pending call was given, so its record lands in the right class.
+        var network:String?
+        var settings:JitterBufferSettings?
+    }
+
+    var policy = JitterBufferPolicy()
+    private let defaults:UserDefaults
+    private let state:OSAllocatedUnfairLock<State>
+
+    private static let defaultsKey = "JitterBufferTuner.state"
+
+    init(defaults:UserDefaults = .standard) {
+        self.defaults = defaults
+        let stored = defaults.data(forKey: JitterBufferTuner.defaultsKey).flatMap { try? JSONDecoder().decode(State.self, from: $0) }
+        state = OSAllocatedUnfairLock(initialState: stored ?? State())
+    }
+
+    func settings(for network:String) -> JitterBufferSettings? {
+        state.withLock { state in
+            state.network = network
+            state.settings = policy.decide(history: state.history[network] ?? [])
+            return state.settings
+        }
+    }
+
+    func audioOptions(for network:String) -> AudioOptions? {
+        guard let settings = settings(for: network) else { return nil }
+        #if DEBUG
+        print("Jitter buffer on \(network): min delay \(settings.minimumDelayMilliseconds) ms, max \(settings.maximumPackets) packets")
+        #endif
+        return AudioOptions { builder in
+            builder.audioJitterBufferMinDelayMs = Int32(settings.minimumDelayMilliseconds)
+            builder.audioJitterBufferMaxPackets = Int32(settings.maximumPackets)
+        }
+    }
+
+    func record(_ history:CallStatsStore) {
+        let snapshot = state.withLock { state -> State? in
+            guard let network = state.network,
+                  let record = JitterCallRecord(history: history, settings: state.settings) else { return nil }
+            state.history[network, default: []].append(record)
+            state.history[network] = Array(state.history[network]!.suffix(policy.window * 2))
+            state.network = nil
+            return state
+        }
+        if let snapshot, let data = try? JSONEncoder().encode(snapshot) {
+            defaults.set(data, forKey: JitterBufferTuner.defaultsKey)
+        }
+    }
+}
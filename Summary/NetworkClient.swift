@@ -0,0 +1,98 @@
+//
+//  NetworkClient.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+struct RequestMetrics:CustomStringConvertible {
+    var url:URL?
+    var networkProtocol:String?
+    var reusedConnection = false
+    var dns:TimeInterval?
+    var connect:TimeInterval?
+    var tls:TimeInterval?
+    var timeToFirstByte:TimeInterval?
+    var transfer:TimeInterval?
+    var total:TimeInterval = 0
+    var interval:DateInterval
+
+    init(_ metrics:URLSessionTaskMetrics, url:URL?) {
+        self.url = url
+        interval = metrics.taskInterval
+        total = metrics.taskInterval.duration
+        guard let transaction = metrics.transactionMetrics.last else { return }
+        networkProtocol = transaction.networkProtocolName
+        reusedConnection = transaction.isReusedConnection
+        dns = RequestMetrics.interval(transaction.domainLookupStartDate, transaction.domainLookupEndDate)
+        connect = RequestMetrics.interval(transaction.connectStartDate, transaction.connectEndDate)
+        tls = RequestMetrics.interval(transaction.secureConnectionStartDate, transaction.secureConnectionEndDate)
+        timeToFirstByte = RequestMetrics.interval(transaction.requestStartDate, transaction.responseStartDate)
+        transfer = RequestMetrics.interval(transaction.responseStartDate, transaction.responseEndDate)
+    }
+
+    var description: String {
+        func ms(_ value:TimeInterval?) -> String {
+            value.map { String(format: "%.1fms", $0 * 1000) } ?? "-"
+        }
+        return "\(url?.host() ?? "?") \(networkProtocol ?? "?")\(reusedConnection ? " reused" : "") dns \(ms(dns)) connect \(ms(connect)) tls \(ms(tls)) ttfb \(ms(timeToFirstByte)) transfer \(ms(transfer)) total \(ms(total))"
+    }
+
+    private static func interval(_ start:Date?, _ end:Date?) -> TimeInterval? {
+        guard let start, let end else { return nil }
+        return end.timeIntervalSince(start)
+    }
+}
+
+// A response outside 2xx from one of the services, kept so callers can tell
+// throttling and server faults from requests that will never succeed.
+struct HTTPStatusError:Error {
+    var statusCode:Int
+}
+
+// One URLSession shared by the Starling, ChatGPT and Twilio services, so
+// connections (HTTP/2 where the server offers it) are pooled and kept alive
+// across services instead of each service going through URLSession.shared.
+final class NetworkClient {
+
+    static let shared = NetworkClient(metricsHandler: NetworkClient.recordMetrics)
+
+    let session:URLSession
+
+    // Per-request timings are collected only when a handler is given.
+    init(configuration:URLSessionConfiguration = NetworkClient.defaultConfiguration(),
+         metricsHandler:((RequestMetrics) -> Void)? = nil) {
+        session = URLSession(configuration: configuration, delegate: metricsHandler.map { MetricsDelegate(handler: $0) }, delegateQueue: nil)
+    }
+
+    // Every request becomes a span in Tracer's export; Debug builds also log the breakdown.
+    static func recordMetrics(_ metrics:RequestMetrics) {
+        Tracer.shared.record("http.request", interval: metrics.interval)
+        #if DEBUG
+        print("Request metrics \(metrics)")
+        #endif
+    }
+
+    static func defaultConfiguration() -> URLSessionConfiguration {
+        let configuration = URLSessionConfiguration.default
+        configuration.httpMaximumConnectionsPerHost = 4
+        configuration.timeoutIntervalForRequest = 30
+        configuration.timeoutIntervalForResource = 120
+        configuration.urlCache = URLCache(memoryCapacity: 4 * 1024 * 1024, diskCapacity: 32 * 1024 * 1024)
+        configuration.requestCachePolicy = .useProtocolCachePolicy
+        return configuration
+    }
+
+    private final class MetricsDelegate:NSObject, URLSessionTaskDelegate {
+        let handler:(RequestMetrics) -> Void
+
+        init(handler: @escaping (RequestMetrics) -> Void) {
+            self.handler = handler
+        }
+
+        func urlSession(_ session: URLSession, task: URLSessionTask, didFinishCollecting metrics: URLSessionTaskMetrics) {
+            handler(RequestMetrics(metrics, url: task.originalRequest?.url))
+        }
+    }
+}
@@ -0,0 +1,233 @@
+//
+//  PCMAssetStore.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import AVFoundation
+import CryptoKit
+import os
+import TwilioVoice
+
+// A pre-rendered summary on disk: a header holding the AudioFormat fields,
+// padded to 16 KiB so the int16 frames start on a page boundary on every
+// device, then the raw interleaved frames. The file is mapped private and
+// copy-on-write, so the mapping can be handed straight to the SDK's non-const
+// capture entry point; a write through it dirties a page in memory, never the
+// file. Nothing is read into memory up front.
+final class PCMAsset {
+
+    static let magic:UInt32 = 0x4D43_5053 // "SPCM"
+    static let version:UInt16 = 1
+    static let dataOffset = 16_384
+
+    let sampleRate:Int
+    let channels:Int
+    let framesPerBuffer:Int
+    let frameCount:Int
+    let samples:UnsafePointer<Int16>
+    private let mapping:UnsafeMutableRawPointer
+    private let length:Int
+
+    var sampleCount:Int {
+        frameCount * channels
+    }
+
+    init(url:URL) throws {
+        let fd = open(url.path, O_RDONLY)
+        guard fd >= 0 else { throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO) }
+        defer { close(fd) }
+        var info = stat()
+        guard fstat(fd, &info) == 0, Int(info.st_size) >= PCMAsset.dataOffset else { throw CocoaError(.fileReadCorruptFile) }
+        length = Int(info.st_size)
+        guard let base = mmap(nil, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0), base != UnsafeMutableRawPointer(bitPattern: -1) else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .ENOMEM)
+        }
+        mapping = base
+        sampleRate = Int(base.loadUnaligned(fromByteOffset: 8, as: UInt32.self))
+        channels = Int(base.loadUnaligned(fromByteOffset: 6, as: UInt16.self))
+        framesPerBuffer = Int(base.loadUnaligned(fromByteOffset: 12, as: UInt32.self))
+        samples = UnsafePointer((base + PCMAsset.dataOffset).assumingMemoryBound(to: Int16.self))
+        // A damaged header must be rejected, not trap, so the summary is rendered again.
+        let frames = Int(exactly: base.loadUnaligned(fromByteOffset: 16, as: UInt64.self))
+        let sampleTotal = frames.map { $0.multipliedReportingOverflow(by: channels) }
+        let byteTotal = sampleTotal.map { $0.partialValue.multipliedReportingOverflow(by: MemoryLayout<Int16>.size) }
+        guard base.loadUnaligned(as: UInt32.self) == PCMAsset.magic,
+              base.loadUnaligned(fromByteOffset: 4, as: UInt16.self) == PCMAsset.version,
+              let frames, let sampleTotal, let byteTotal, !sampleTotal.overflow, !byteTotal.overflow,
+              byteTotal.partialValue <= length - PCMAsset.dataOffset else {
+            munmap(base, length)
+            throw CocoaError(.fileReadCorruptFile)
+        }
+        frameCount = frames
+        // Playback reads front to back once; prefetch the first second.
+        madvise(base, length, MADV_SEQUENTIAL)
+        madvise(base + PCMAsset.dataOffset, min(length - PCMAsset.dataOffset, sampleRate * channels * MemoryLayout<Int16>.size), MADV_WILLNEED)
+    }
+
+    deinit {
+        munmap(mapping, length)
+    }
+
+    static func header(sampleRate:Int, channels:Int, framesPerBuffer:Int, frameCount:Int) -> Data {
+        var header = Data(count: dataOffset)
+        header.withUnsafeMutableBytes { bytes in
+            bytes.storeBytes(of: magic, toByteOffset: 0, as: UInt32.self)
+            bytes.storeBytes(of: version, toByteOffset: 4, as: UInt16.self)
+            bytes.storeBytes(of: UInt16(channels), toByteOffset: 6, as: UInt16.self)
+            bytes.storeBytes(of: UInt32(sampleRate), toByteOffset: 8, as: UInt32.self)
+            bytes.storeBytes(of: UInt32(framesPerBuffer), toByteOffset: 12, as: UInt32.self)
+            bytes.storeBytes(of: UInt64(frameCount), toByteOffset: 16, as: UInt64.self)
+        }
+        return header
+    }
+}
+
+// Keeps rendered summaries under Caches, keyed by text and format. Open assets
+// are shared, so concurrent calls playing the same summary use one mapping, and
+// are released when their call ends. Each write prunes the directory to
+// `maximumBytes`, least recently played first, and drops files older than `maximumAge`.
+final class PCMAssetStore {
+
+    static let shared = PCMAssetStore(directory: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appending(path: "summary-audio"))
+
+    let directory:URL
+    var maximumBytes = 64 << 20
+    var maximumAge = Duration.seconds(7 * 24 * 60 * 60)
+    private let assets = OSAllocatedUnfairLock(initialState: [String:PCMAsset]())
+
+    init(directory:URL) {
+        self.directory = directory
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    static func key(summary:String, format:AudioFormat) -> String {
+        let digest = SHA256.hash(data: Data("\(format.sampleRate)/\(format.numberOfChannels)/\(summary)".utf8))
+        return digest.map { String(format: "%02x", $0) }.joined()
+    }
+
+    func url(forKey key:String) -> URL {
+        directory.appending(path: "\(key).pcm")
+    }
+
+    // The shared mapping for `key`, mapping the file on first use. Nil when nothing is stored.
+    func asset(forKey key:String) -> PCMAsset? {
+        if let asset = assets.withLock({ $0[key] }) {
+            return asset
+        }
+        guard let asset = try? PCMAsset(url: url(forKey: key)) else { return nil }
+        // The modification date doubles as the last-played time for pruning.
+        try? FileManager.default.setAttributes([.modificationDate: Date()], ofItemAtPath: url(forKey: key).path)
+        return assets.withLock { assets in
+            if let existing = assets[key] {
+                return existing
+            }
+            assets[key] = asset
+            return asset
+        }
+    }
+
+    // Writes interleaved int16 buffers as one asset and returns its mapping,
+    // dropping silence first when a trimmer is given.
+    @discardableResult
+    func write(_ buffers:[AVAudioPCMBuffer], format:AudioFormat, forKey key:String, trimmer:SilenceTrimmer? = nil) throws -> PCMAsset {
+        try write(forKey: key, sampleRate: Int(format.sampleRate), channels: format.numberOfChannels, framesPerBuffer: format.framesPerBuffer) { handle in
+            var written = 0
+            let append = { (samples:UnsafePointer<Int16>, count:Int) throws in
+                try handle.write(contentsOf: Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: samples),
+                                                  count: count * MemoryLayout<Int16>.size, deallocator: .none))
+                written += count
+            }
+            for buffer in buffers {
+                guard let data = buffer.int16ChannelData else { continue }
+                let count = Int(buffer.frameLength) * format.numberOfChannels
+                if let trimmer {
+                    try trimmer.consume(data[0], count: count, emit: append)
+                } else {
+                    try append(data[0], count)
+                }
+            }
+            try trimmer?.finish(emit: append)
+            return written / format.numberOfChannels
+        }
+    }
+
+    // Writes a placeholder header, lets `body` append the frames and return how
+    // many it wrote, patches the header, then moves the file into place so
+    // readers never see a partial asset.
+    @discardableResult
+    func write(forKey key:String, sampleRate:Int, channels:Int, framesPerBuffer:Int,
+               _ body:(FileHandle) throws -> Int) throws -> PCMAsset {
+        let destination = url(forKey: key)
+        let temporary = directory.appending(path: "\(key).\(UUID().uuidString).tmp")
+        FileManager.default.createFile(atPath: temporary.path, contents: nil)
+        let handle = try FileHandle(forWritingTo: temporary)
+        do {
+            try handle.write(contentsOf: PCMAsset.header(sampleRate: sampleRate, channels: channels,
+                                                          framesPerBuffer: framesPerBuffer, frameCount: 0))
+            let frameCount = try body(handle)
+            try handle.seek(toOffset: 0)
+            try handle.write(contentsOf: PCMAsset.header(sampleRate: sampleRate, channels: channels,
+                                                          framesPerBuffer: framesPerBuffer, frameCount: frameCount))
+            try handle.close()
+        } catch {
+            try? handle.close()
+            try? FileManager.default.removeItem(at: temporary)
+            throw error
+        }
+        guard rename(temporary.path, destination.path) == 0 else {
+            try? FileManager.default.removeItem(at: temporary)
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+        let asset = try PCMAsset(url: destination)
+        assets.withLock { $0[key] = asset }
+        prune()
+        return asset
+    }
+
+    // Drops the store's mapping for `key`. A capturer still playing it keeps its
+    // own reference, so the file is unmapped once that call lets go too.
+    func release(forKey key:String) {
+        assets.withLock { $0[key] = nil }
+    }
+
+    // Removes stale temporaries, assets older than `maximumAge`, then the least
+    // recently played assets until the directory fits `maximumBytes`. Mapped
+    // assets are skipped; unlinking them would be safe, but they are in use.
+    func prune(now:Date = Date()) {
+        let fileManager = FileManager.default
+        let keys:[URLResourceKey] = [.contentModificationDateKey, .fileSizeKey]
+        guard let urls = try? fileManager.contentsOfDirectory(at: directory, includingPropertiesForKeys: keys) else { return }
+        let mapped = assets.withLock { Set($0.keys) }
+        var files = [(url:URL, modified:Date, size:Int)]()
+        for url in urls {
+            guard let values = try? url.resourceValues(forKeys: Set(keys)) else { continue }
+            let modified = values.contentModificationDate ?? .distantPast
+            let size = values.fileSize ?? 0
+            let stale = now.timeIntervalSince(modified) > maximumAge.timeInterval
+            if url.pathExtension == "tmp" {
+                // Writers finish in seconds; an hour-old temporary was abandoned by a crash.
+                if now.timeIntervalSince(modified) > 60 * 60 {
+                    try? fileManager.removeItem(at: url)
+                }
+            } else if mapped.contains(url.deletingPathExtension().lastPathComponent) {
+                continue
+            } else if stale {
+                try? fileManager.removeItem(at: url)
+            } else {
+                files.append((url, modified, size))
+            }
+        }
+        var total = files.reduce(0) { $0 + $1.size }
+        for file in files.sorted(by: { $0.modified < $1.modified }) where total > maximumBytes {
+            try? fileManager.removeItem(at: file.url)
+            total -= file.size
+        }
+    }
+
+    // Unmaps idle assets; calls still playing keep theirs alive.
+    func evictAll() {
+        assets.withLock { $0.removeAll() }
+    }
+}
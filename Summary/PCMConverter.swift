@@ -0,0 +1,295 @@
+//
+//  PCMConverter.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import TwilioVoice
+
+// Converts interleaved int16 PCM between any two AudioFormat rates (8-48 kHz)
+// and mono/stereo layouts, e.g. the 48 kHz session format and an 8 kHz PCMU call.
+// Resampling is linear interpolation in Q15 fixed point driven by a precomputed
+// phase table. Downsampling first runs a Blackman-windowed sinc low-pass at the
+// source rate, cut off just below the target Nyquist, so content the target
+// rate cannot carry is removed instead of folding back as aliasing.
+// The vector path uses Swift SIMD types (NEON on device, SSE in the simulator)
+// for the low-pass and the channel mixing, which read contiguous samples, with
+// the same integer arithmetic as the scalar path, so both produce identical
+// samples. Interpolation reads irregularly spaced frames and is scalar in both.
+// Everything is allocated in init; `convert` never allocates and can run inside
+// an audio callback.
+final class PCMConverter {
+
+    enum Path {
+        case scalar
+        case vector
+    }
+
+    static let supportedRates = [AudioFormat.SampleRate8000, AudioFormat.SampleRate16000, AudioFormat.SampleRate24000,
+                                 AudioFormat.SampleRate32000, AudioFormat.SampleRate44100, AudioFormat.SampleRate48000].map { Int($0) }
+
+    let sourceRate:Int
+    let targetRate:Int
+    let sourceChannels:Int
+    let targetChannels:Int
+    let maximumInputFrames:Int
+    var path = Path.vector
+
+    // One period of the rate ratio: output j of a period reads source frames
+    // phaseIndex[j] and phaseIndex[j] + 1, weighted by phaseFraction[j] / 32768.
+    private let phaseIndex:UnsafeMutablePointer<Int>
+    private let phaseFraction:UnsafeMutablePointer<Int32>
+    private let periodInput:Int
+    private let periodOutput:Int
+    private let resampleChannels:Int
+    private let scratch:UnsafeMutablePointer<Int16>
+    // Anti-alias low-pass taps in Q15, empty when not downsampling. `filterLine`
+    // holds the last taps - 1 frames of the previous chunk followed by the current one.
+    private let taps:Int
+    private let coefficients:UnsafeMutablePointer<Int32>
+    private let filterLine:UnsafeMutablePointer<Int16>
+    private let filtered:UnsafeMutablePointer<Int16>
+    // Last frame of the previous chunk, read as source frame 0 of the next one.
+    private let history:UnsafeMutablePointer<Int16>
+    private var phase = 0
+    private var base = 1
+
+    init(sourceRate:Int, sourceChannels:Int, targetRate:Int, targetChannels:Int, maximumInputFrames:Int) {
+        precondition([1, 2].contains(sourceChannels) && [1, 2].contains(targetChannels), "Only mono and stereo are supported")
+        self.sourceRate = sourceRate
+        self.targetRate = targetRate
+        self.sourceChannels = sourceChannels
+        self.targetChannels = targetChannels
+        self.maximumInputFrames = maximumInputFrames
+        resampleChannels = min(sourceChannels, targetChannels)
+
+        var a = sourceRate, b = targetRate
+        while b != 0 {
+            (a, b) = (b, a % b)
+        }
+        periodInput = sourceRate / a
+        periodOutput = targetRate / a
+        phaseIndex = .allocate(capacity: periodOutput)
+        phaseFraction = .allocate(capacity: periodOutput)
+        for j in 0..<periodOutput {
+            // Source position of output j in units of 1/periodOutput frames.
+            let position = j * periodInput
+            phaseIndex[j] = position / periodOutput
+            phaseFraction[j] = Int32(((position % periodOutput) << 15) / periodOutput)
+        }
+
+        // Stopband width scales with the taps, so wider ratios get proportionally more.
+        taps = targetRate < sourceRate ? 32 * ((sourceRate + targetRate - 1) / targetRate) + 1 : 0
+        coefficients = .allocate(capacity: max(taps, 1))
+        if taps > 0 {
+            // Cut off at 90% of the target Nyquist, in cycles per source frame.
+            let cutoff = 0.45 * Double(targetRate) / Double(sourceRate)
+            let centre = Double(taps - 1) / 2
+            let window = (0..<taps).map { k -> Double in
+                let x = Double(k) - centre
+                let sinc = x == 0 ? 2 * cutoff : sin(2 * .pi * cutoff * x) / (.pi * x)
+                let blackman = 0.42 - 0.5 * cos(2 * .pi * Double(k) / Double(taps - 1)) + 0.08 * cos(4 * .pi * Double(k) / Double(taps - 1))
+                return sinc * blackman
+            }
+            let gain = window.reduce(0, +)
+            var sum:Int32 = 0
+            for k in 0..<taps {
+                coefficients[k] = Int32((window[k] / gain * 32768).rounded())
+                sum += coefficients[k]
+            }
+            // Unity DC gain after rounding.
+            coefficients[taps / 2] += 32768 - sum
+        }
+        let lineSamples = (max(taps - 1, 0) + maximumInputFrames) * resampleChannels
+        filterLine = .allocate(capacity: lineSamples)
+        filterLine.initialize(repeating: 0, count: lineSamples)
+        filtered = .allocate(capacity: maximumInputFrames * resampleChannels)
+        filtered.initialize(repeating: 0, count: maximumInputFrames * resampleChannels)
+
+        let scratchFrames = max(maximumInputFrames, (maximumInputFrames * targetRate + sourceRate - 1) / sourceRate + 1)
+        scratch = .allocate(capacity: scratchFrames)
+        scratch.initialize(repeating: 0, count: scratchFrames)
+        history = .allocate(capacity: 2)
+        history.initialize(repeating: 0, count: 2)
+    }
+
+    convenience init(source:AudioFormat, target:AudioFormat) {
+        self.init(sourceRate: Int(source.sampleRate), sourceChannels: Int(source.numberOfChannels),
+                  targetRate: Int(target.sampleRate), targetChannels: Int(target.numberOfChannels),
+                  maximumInputFrames: Int(source.framesPerBuffer) * 4)
+    }
+
+    deinit {
+        phaseIndex.deallocate()
+        phaseFraction.deallocate()
+        scratch.deallocate()
+        coefficients.deallocate()
+        filterLine.deallocate()
+        filtered.deallocate()
+        history.deallocate()
+    }
+
+    // Upper bound on the frames a single `convert` call can produce.
+    func maximumOutputFrames(forInputFrames frames:Int) -> Int {
+        (frames * targetRate + sourceRate - 1) / sourceRate + 1
+    }
+
+    // Converts `frames` input frames and returns the number of output frames
+    // written. `output` must hold maximumOutputFrames(forInputFrames:) frames.
+    @discardableResult
+    func convert(_ input:UnsafePointer<Int16>, frames:Int, into output:UnsafeMutablePointer<Int16>) -> Int {
+        precondition(frames <= maximumInputFrames, "Chunk larger than maximumInputFrames")
+        switch (sourceChannels, targetChannels) {
+        case (2, 1):
+            if sourceRate == targetRate {
+                downmix(input, frames: frames, into: output)
+                return frames
+            }
+            downmix(input, frames: frames, into: scratch)
+            return resample(scratch, frames: frames, into: output)
+        case (1, 2):
+            let produced = resample(input, frames: frames, into: scratch)
+            upmix(scratch, frames: produced, into: output)
+            return produced
+        default:
+            return resample(input, frames: frames, into: output)
+        }
+    }
+
+    // Forgets the stream position, e.g. when the device restarts.
+    func reset() {
+        phase = 0
+        base = 1
+        history.update(repeating: 0, count: 2)
+        filterLine.update(repeating: 0, count: max(taps - 1, 0) * resampleChannels)
+    }
+
+    // MARK: Resampling
+
+    private func resample(_ input:UnsafePointer<Int16>, frames:Int, into output:UnsafeMutablePointer<Int16>) -> Int {
+        if sourceRate == targetRate {
+            output.update(from: input, count: frames * resampleChannels)
+            return frames
+        }
+        guard taps > 0 else {
+            return interpolate(input, frames: frames, into: output)
+        }
+        lowPass(input, frames: frames)
+        return interpolate(filtered, frames: frames, into: output)
+    }
+
+    private func interpolate(_ input:UnsafePointer<Int16>, frames:Int, into output:UnsafeMutablePointer<Int16>) -> Int {
+        let channels = resampleChannels
+        var produced = 0
+        while base + phaseIndex[phase] + 1 <= frames {
+            let index = base + phaseIndex[phase]
+            let fraction = phaseFraction[phase]
+            for channel in 0..<channels {
+                let s0 = Int32(sample(index, channel, input))
+                let s1 = Int32(sample(index + 1, channel, input))
+                output[produced * channels + channel] = Int16(truncatingIfNeeded: s0 + (((s1 - s0) * fraction) >> 15))
+            }
+            produced += 1
+            advance()
+        }
+        if frames > 0 {
+            for channel in 0..<channels {
+                history[channel] = input[(frames - 1) * channels + channel]
+            }
+            base -= frames
+        }
+        return produced
+    }
+
+    @inline(__always)
+    private func sample(_ frame:Int, _ channel:Int, _ input:UnsafePointer<Int16>) -> Int16 {
+        frame == 0 ? history[channel] : input[(frame - 1) * resampleChannels + channel]
+    }
+
+    @inline(__always)
+    private func advance() {
+        phase += 1
+        if phase == periodOutput {
+            phase = 0
+            base += periodInput
+        }
+    }
+
+    // MARK: Anti-aliasing
+
+    // Filters `frames` frames into `filtered`. Output sample s is the dot product
+    // of the taps with filterLine[s], [s + channels], ..., so eight consecutive
+    // outputs read eight consecutive samples per tap in either layout. The
+    // filter delays the stream by (taps - 1) / 2 frames.
+    private func lowPass(_ input:UnsafePointer<Int16>, frames:Int) {
+        let channels = resampleChannels
+        let delay = (taps - 1) * channels
+        let count = frames * channels
+        (filterLine + delay).update(from: input, count: count)
+        var s = 0
+        if path == .vector {
+            let lower = SIMD8<Int32>(repeating: Int32(Int16.min))
+            let upper = SIMD8<Int32>(repeating: Int32(Int16.max))
+            while s + 8 <= count {
+                var sum = SIMD8<Int32>(repeating: 1 << 14)
+                for k in 0..<taps {
+                    let samples = UnsafeRawPointer(filterLine + s + k * channels).loadUnaligned(as: SIMD8<Int16>.self)
+                    sum &+= SIMD8<Int32>(truncatingIfNeeded: samples) &* coefficients[k]
+                }
+                let clamped = (sum &>> 15).clamped(lowerBound: lower, upperBound: upper)
+                UnsafeMutableRawPointer(filtered + s).storeBytes(of: SIMD8<Int16>(truncatingIfNeeded: clamped), as: SIMD8<Int16>.self)
+                s += 8
+            }
+        }
+        while s < count {
+            var sum:Int32 = 1 << 14
+            for k in 0..<taps {
+                sum &+= Int32(filterLine[s + k * channels]) &* coefficients[k]
+            }
+            filtered[s] = Int16(clamping: sum &>> 15)
+            s += 1
+        }
+        // Keep the newest taps - 1 frames for the next chunk; the ranges may overlap.
+        filterLine.update(from: filterLine + count, count: delay)
+    }
+
+    // MARK: Channel mixing
+
+    // Stereo to mono averages the two channels.
+    private func downmix(_ input:UnsafePointer<Int16>, frames:Int, into output:UnsafeMutablePointer<Int16>) {
+        var frame = 0
+        if path == .vector {
+            while frame + 8 <= frames {
+                let pairs = UnsafeRawPointer(input + frame * 2).loadUnaligned(as: SIMD16<Int16>.self)
+                let mixed = (SIMD8<Int32>(truncatingIfNeeded: pairs.evenHalf) &+ SIMD8<Int32>(truncatingIfNeeded: pairs.oddHalf)) &>> 1
+                UnsafeMutableRawPointer(output + frame).storeBytes(of: SIMD8<Int16>(truncatingIfNeeded: mixed), as: SIMD8<Int16>.self)
+                frame += 8
+            }
+        }
+        while frame < frames {
+            output[frame] = Int16(truncatingIfNeeded: (Int32(input[frame * 2]) + Int32(input[frame * 2 + 1])) >> 1)
+            frame += 1
+        }
+    }
+
+    // Mono to stereo copies the sample into both channels.
+    private func upmix(_ input:UnsafePointer<Int16>, frames:Int, into output:UnsafeMutablePointer<Int16>) {
+        var frame = 0
+        if path == .vector {
+            var pairs = SIMD16<Int16>()
+            while frame + 8 <= frames {
+                let mono = UnsafeRawPointer(input + frame).loadUnaligned(as: SIMD8<Int16>.self)
+                pairs.evenHalf = mono
+                pairs.oddHalf = mono
+                UnsafeMutableRawPointer(output + frame * 2).storeBytes(of: pairs, as: SIMD16<Int16>.self)
+                frame += 8
+            }
+        }
+        while frame < frames {
+            output[frame * 2] = input[frame]
+            output[frame * 2 + 1] = input[frame]
+            frame += 1
+        }
+    }
+}
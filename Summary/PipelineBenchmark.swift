@@ -0,0 +1,308 @@
+//
+//  PipelineBenchmark.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+#if DEBUG
+import Foundation
+
+// Offline benchmark for fetch -> summarize -> call. All three services run against
+// ReplayURLProtocol, so no network or credentials are needed. Launch a Debug build
+// with the `-runBenchmarks` argument to print the report and exit.
+struct PipelineBenchmark {
+
+    struct Options {
+        var iterations = 50
+        var batchAccounts = 500
+        var latency:TimeInterval = 0.02
+        var failureRate = 0.0
+        var promptLatencyPerKiB:TimeInterval = 0.01
+    }
+
+    struct Result:CustomStringConvertible {
+        var name:String
+        var report:BatchReport
+        // Heap still in use after the run minus before it, not the total allocated along the way.
+        var allocatedBytes:Int
+        var allocations:Int
+        var peakMemory:Int
+
+        var description: String {
+            "\(name): \(report), net heap growth \(allocatedBytes / 1024) KiB in \(allocations) blocks, peak memory \(peakMemory / (1024 * 1024)) MiB"
+        }
+    }
+
+    static var isRequested:Bool {
+        ProcessInfo.processInfo.arguments.contains("-runBenchmarks")
+    }
+
+    var options = Options()
+
+    func run() async -> [BenchmarkCheck] {
+        installRoutes()
+        let client = NetworkClient(configuration: ReplayURLProtocol.configuration())
+        var starling = StarlingService()
+        starling.session = client.session
+        var chatgpt = ChatGPTService()
+        chatgpt.session = client.session
+        var twilio = TwilioService()
+        twilio.session = client.session
+
+        var results = [Result]()
+        // Mirrors SummaryViewModel: compacted prompt, streamed completion, then the call.
+        results.append(await measure("single account") {
+            let compactor = PromptCompactor()
+            var report = BatchReport()
+            let clock = ContinuousClock()
+            let start = clock.now
+            for _ in 0..<options.iterations {
+                let iterationStart = clock.now
+                do {
+                    let (account, _) = try await starling.fetchAccount()
+                    let content = starling.summary(for: compactor.compact(account, using: starling))
+                    var summary = ""
+                    for try await delta in chatgpt.streamSummary(content: content) {
+                        summary += delta
+                    }
+                    try await twilio.placeCall(content: summary)
+                    report.succeeded += 1
+                    report.latencies.append(iterationStart.duration(to: clock.now))
+                } catch {
+                    report.failed.append(error.localizedDescription)
+                }
+            }
+            report.elapsed = start.duration(to: clock.now)
+            return report
+        })
+        results.append(await measure("batch") {
+            let engine = BatchSummaryEngine(starlingService: starling, chatgptService: chatgpt) { _, summary in
+                try await twilio.placeCall(content: summary)
+            }
+            let accounts = (0..<options.batchAccounts).map { BatchAccount(accountUid: "account-\($0)", customerName: "Customer \($0)") }
+            return await engine.run(accounts: accounts)
+        })
+        let replayAccount = try? await starling.fetchAccount().0
+        let fetch = await verifyConcurrentFetch(starling)
+        let streamed = await verifyStreamedSummary(chatgpt)
+        let revalidated = await verifyRevalidation(client.session)
+        let large = Self.largeAccount()
+        let fullLatency = await endToEndLatency(large, compactor: PromptCompactor(tokenBudget: .max), starling: starling, chatgpt: chatgpt, twilio: twilio)
+        let compactedLatency = await endToEndLatency(large, compactor: PromptCompactor(), starling: starling, chatgpt: chatgpt, twilio: twilio)
+        ReplayURLProtocol.reset()
+        var checks = [BenchmarkCheck]()
+        for result in results {
+            print("Benchmark \(result)")
+            // Without injected failures every account should go through.
+            checks.append(BenchmarkCheck(name: "\(result.name) without failures", passed: options.failureRate > 0 || result.report.failed.isEmpty))
+        }
+        print("Benchmark Starling revalidation: \(revalidated)")
+        checks.append(BenchmarkCheck(name: "Starling revalidation", passed: revalidated))
+        let parsed = verifySSEParser()
+        print("Benchmark SSEParser fixtures: \(parsed)")
+        checks.append(BenchmarkCheck(name: "SSEParser fixtures", passed: parsed))
+        print("Benchmark ChatGPT streamed summary: \(streamed)")
+        checks.append(BenchmarkCheck(name: "ChatGPT streamed summary", passed: streamed))
+        print("Benchmark Starling concurrent fetch: \(fetch.concurrent), \(fetch.timings.map { "\($0)" } ?? "failed")")
+        checks.append(BenchmarkCheck(name: "Starling concurrent fetch", passed: fetch.concurrent))
+        let budget = PromptCompactor().tokenBudget
+        for (name, account) in [("replay account", replayAccount), ("large account", Self.largeAccount())] {
+            guard let account else { continue }
+            let tokens = promptTokens(account, using: starling)
+            print("Benchmark prompt compaction \(name): ~\(tokens.full) tokens full, ~\(tokens.compacted) compacted, budget \(budget)")
+            checks.append(BenchmarkCheck(name: "prompt compaction \(name) within budget", passed: tokens.compacted <= budget))
+        }
+        print("Benchmark prompt compaction large account end to end: p50 \(fullLatency.map { "\($0)" } ?? "failed") full, \(compactedLatency.map { "\($0)" } ?? "failed") compacted")
+        if let fullLatency, let compactedLatency {
+            checks.append(BenchmarkCheck(name: "prompt compaction end to end not slower", passed: compactedLatency <= fullLatency))
+        } else {
+            checks.append(BenchmarkCheck(name: "prompt compaction end to end without failures", passed: options.failureRate > 0))
+        }
+        return checks
+    }
+
+    // Each Starling route waits `latency`, so a concurrent fetch takes about as long
+    // as its slowest request while a sequential one would take their sum.
+    func verifyConcurrentFetch(_ starling:StarlingService) async -> (concurrent:Bool, timings:FetchTimings?) {
+        guard let (_, timings) = try? await starling.fetchAccount() else { return (false, nil) }
+        let sequential = timings.balance + timings.spendings + timings.directDebits
+        return (timings.total < sequential * 0.75, timings)
+    }
+
+    // A second fetch with fresh validators should send all three conditional
+    // requests, get 304 for each and rebuild the same snapshot from the stored values.
+    func verifyRevalidation(_ session:URLSession) async -> Bool {
+        var starling = StarlingService()
+        starling.session = session
+        starling.validators = ValidatorStore()
+        guard let (first, _) = try? await starling.fetchAccount(),
+              let (second, _) = try? await starling.fetchAccount() else { return false }
+        let stats = await starling.validators.stats
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = .sortedKeys
+        return stats.conditionalRequests == 3 && stats.notModified == 3 && (try? encoder.encode(first)) == (try? encoder.encode(second))
+    }
+
+    // The stream fixture parsed whole and fed in uneven pieces must give the same
+    // events, and an unterminated final event is flushed by `finish()`.
+    func verifySSEParser() -> Bool {
+        let fixture = Data(PipelineBenchmark.streamFixture.utf8)
+        let expected = [
+            #"{"choices":[{"index":0,"delta":{"role":"assistant","content":""}}]}"#,
+            #"{"choices":[{"index":0,"delta":{"content":"Hello, here is a summary "}}]}"#,
+            #"{"choices":[{"index":0,"delta":{"content":"of your account for last month: £2,543.10."}}]}"#,
+            "[DONE]"
+        ]
+        guard SSEParser.parse(fixture).map(\.data) == expected else { return false }
+        var generator = SplitMix64(seed: 3)
+        var parser = SSEParser()
+        var events = [String]()
+        var offset = 0
+        while offset < fixture.count {
+            let end = min(fixture.count, offset + Int(generator.next() % 7) + 1)
+            for byte in fixture[offset..<end] {
+                if let event = parser.consume(byte) {
+                    events.append(event.data)
+                }
+            }
+            offset = end
+        }
+        if let event = parser.finish() {
+            events.append(event.data)
+        }
+        guard events == expected else { return false }
+        let trailing = SSEParser.parse(Data("event: delta\ndata: first\ndata: second".utf8))
+        return trailing.count == 1 && trailing[0].event == "delta" && trailing[0].data == "first\nsecond"
+    }
+
+    func verifyStreamedSummary(_ chatgpt:ChatGPTService) async -> Bool {
+        var summary = ""
+        do {
+            for try await delta in chatgpt.streamSummary(content: "fixture") {
+                summary += delta
+            }
+        } catch {
+            return false
+        }
+        return summary == "Hello, here is a summary of your account for last month: £2,543.10."
+    }
+
+    // Median prompt -> streamed summary -> call latency for one account, without
+    // the fetch, so only the prompt size differs between compactors.
+    func endToEndLatency(_ account:AccountSnapshot, compactor:PromptCompactor, starling:StarlingService,
+                         chatgpt:ChatGPTService, twilio:TwilioService) async -> Duration? {
+        let clock = ContinuousClock()
+        var latencies = [Duration]()
+        for _ in 0..<max(1, options.iterations / 5) {
+            let start = clock.now
+            do {
+                let content = starling.summary(for: compactor.compact(account, using: starling))
+                var summary = ""
+                for try await delta in chatgpt.streamSummary(content: content) {
+                    summary += delta
+                }
+                try await twilio.placeCall(content: summary)
+                latencies.append(start.duration(to: clock.now))
+            } catch {
+                return nil
+            }
+        }
+        return latencies.sorted()[latencies.count / 2]
+    }
+
+    func promptTokens(_ account:AccountSnapshot, using starling:StarlingService) -> (full:Int, compacted:Int) {
+        let compacted = PromptCompactor().compact(account, using: starling)
+        return (starling.prompt(for: account).estimatedTokens, starling.prompt(for: compacted).estimatedTokens)
+    }
+
+    // More categories and mandates than the budget holds, with repeated and cancelled mandates.
+    static func largeAccount() -> AccountSnapshot {
+        let categories = (0..<60).map { Category(spendingCategory: "CATEGORY_\($0)", totalSpent: Double(($0 * 37) % 500) + 0.5) }
+        let mandates = (0..<80).map { Mandate(reference: "MERCHANT \($0 % 50)", status: $0 % 7 == 0 ? "CANCELLED" : "LIVE") }
+        return AccountSnapshot(balance: Balance(amount: Amount(currency: "GBP", minorUnits: 254_310)),
+                               spendings: Spendings(totalSpent: categories.reduce(0) { $0 + $1.totalSpent }, breakdown: categories),
+                               directDebits: DirectDebits(mandates: mandates))
+    }
+
+    private func measure(_ name:String, _ body: () async -> BatchReport) async -> Result {
+        let before = BenchmarkMemory.allocations()
+        let report = await body()
+        let after = BenchmarkMemory.allocations()
+        return Result(name: name,
+                      report: report,
+                      allocatedBytes: max(0, after.bytes - before.bytes),
+                      allocations: max(0, after.blocks - before.blocks),
+                      peakMemory: BenchmarkMemory.peakResidentBytes())
+    }
+
+    // A recorded chat completion stream, with a comment line, CRLF line endings
+    // and a non-ASCII character in the content.
+    static let streamFixture = """
+        : keep-alive\r
+        data: {"choices":[{"index":0,"delta":{"role":"assistant","content":""}}]}\r
+        \r
+        data: {"choices":[{"index":0,"delta":{"content":"Hello, here is a summary "}}]}
+
+        data: {"choices":[{"index":0,"delta":{"content":"of your account for last month: £2,543.10."}}]}
+
+        data: [DONE]
+
+
+        """
+
+    private func installRoutes() {
+        ReplayURLProtocol.reset()
+        func route(_ body:String, etag:String? = nil) -> ReplayURLProtocol.Route {
+            ReplayURLProtocol.Route(body: Data(body.utf8), latency: options.latency, failureRate: options.failureRate, etag: etag)
+        }
+        // Starling answers repeat fetches of an account with 304 Not Modified.
+        ReplayURLProtocol.register(route(#"{"amount":{"currency":"GBP","minorUnits":254310}}"#, etag: #""balance-1""#), forURLContaining: "/balance")
+        ReplayURLProtocol.register(route(#"{"totalSpent":1234.56,"breakdown":[{"spendingCategory":"GROCERIES","totalSpent":412.3},{"spendingCategory":"EATING_OUT","totalSpent":220.1},{"spendingCategory":"TRANSPORT","totalSpent":98.4},{"spendingCategory":"BILLS_AND_SERVICES","totalSpent":503.76}]}"#, etag: #""spending-1""#), forURLContaining: "/spending-category")
+        ReplayURLProtocol.register(route(#"{"mandates":[{"reference":"NETFLIX","status":"LIVE"},{"reference":"COUNCIL TAX","status":"LIVE"},{"reference":"GYM","status":"CANCELLED"}]}"#, etag: #""mandates-1""#), forURLContaining: "/direct-debit/mandates")
+        var stream = route(PipelineBenchmark.streamFixture)
+        stream.headers = ["Content-Type": "text/event-stream"]
+        // Longer prompts take the model longer to read before the first token.
+        stream.latencyPerKiB = options.promptLatencyPerKiB
+        stream.accept = "text/event-stream"
+        ReplayURLProtocol.register(stream, forURLContaining: "api.openai.com")
+        ReplayURLProtocol.register(route(#"{"choices":[{"index":0,"message":{"role":"assistant","content":"Hello, here is a summary of your account for last month."}}]}"#), forURLContaining: "api.openai.com")
+        var call = route(#"{"sid":"CA00000000000000000000000000000000","status":"queued"}"#)
+        call.status = 201
+        ReplayURLProtocol.register(call, forURLContaining: "api.twilio.com")
+    }
+}
+
+// Pass or fail of one offline check. SummaryApp exits non-zero when any fails,
+// so the harness can gate a CI run.
+struct BenchmarkCheck {
+    var name:String
+    var passed:Bool
+}
+
+enum BenchmarkMemory {
+
+    static func allocations() -> (bytes:Int, blocks:Int) {
+        var stats = malloc_statistics_t()
+        malloc_zone_statistics(nil, &stats)
+        return (Int(stats.size_in_use), Int(stats.blocks_in_use))
+    }
+
+    static func peakResidentBytes() -> Int {
+        var usage = rusage()
+        getrusage(RUSAGE_SELF, &usage)
+        // ru_maxrss is reported in bytes on Darwin.
+        return Int(usage.ru_maxrss)
+    }
+
+    static func residentBytes() -> Int {
+        var info = mach_task_basic_info()
+        var count = mach_msg_type_number_t(MemoryLayout<mach_task_basic_info>.size / MemoryLayout<natural_t>.size)
+        let result = withUnsafeMutablePointer(to: &info) {
+            $0.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(MACH_TASK_BASIC_INFO), $0, &count)
+            }
+        }
+        return result == KERN_SUCCESS ? Int(info.resident_size) : 0
+    }
+}
+#endif
@@ -0,0 +1,234 @@
+//
+//  PreflightService.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import Network
+import os
+import TwilioVoice
+
+// What a preflight measured, copied out of PreflightReport so verdicts can be
+// cached, persisted and replayed without the SDK objects.
+struct PreflightRecord:Codable {
+
+    // Mirrors PreflightCallQuality.
+    enum Quality:Int, Codable {
+        case excellent
+        case great
+        case good
+        case fair
+        case degraded
+    }
+
+    var completedAt:Date
+    var failed = false
+    var quality:Quality?
+    var signalingMilliseconds:Double?
+    var iceConnectionMilliseconds:Double?
+    var roundTripTime:Double?
+    var jitter:Double?
+    var mos:Double?
+    var isTurnRequired = false
+}
+
+extension PreflightRecord {
+
+    init(report:PreflightReport, completedAt:Date = Date()) {
+        self.init(completedAt: completedAt,
+                  quality: report.callQuality.flatMap { Quality(rawValue: $0.intValue) },
+                  signalingMilliseconds: report.networkTimings.signalingTimeMeasurement.duration,
+                  iceConnectionMilliseconds: report.networkTimings.iceConnectionTimeMeasurement.duration,
+                  roundTripTime: report.networkStats.rtt.average,
+                  jitter: report.networkStats.jitter.average,
+                  mos: report.networkStats.mos.average,
+                  isTurnRequired: report.isTurnRequired?.boolValue ?? false)
+    }
+
+    // Only failures the network caused say anything about how to place the call.
+    // A bad token or a server-side error would fail the call too, but relaying it would not help.
+    static func isNetworkFailure(_ error:Error) -> Bool {
+        let error = error as NSError
+        if error.domain == NSURLErrorDomain {
+            return true
+        }
+        guard error.domain == TwilioVoiceSDK.ErrorDomain else { return false }
+        // Connection, transport, request timeout, DNS, signaling disconnected, media connection and DTLS failures.
+        return [31005, 31009, 31408, 31530, 53001, 53405, 53407].contains(error.code)
+    }
+}
+
+// How to place the call on this network.
+struct PreflightVerdict:Codable {
+    var record:PreflightRecord
+    var opusBitrate:Int?
+    var relayOnly:Bool
+}
+
+// Pure mapping from a preflight record to call settings.
+struct PreflightPolicy {
+
+    func verdict(for record:PreflightRecord) -> PreflightVerdict {
+        // A failed preflight usually means direct UDP is blocked, so go through TURN at a safe bitrate.
+        if record.failed {
+            return PreflightVerdict(record: record, opusBitrate: 16_000, relayOnly: true)
+        }
+        let bitrate:Int?
+        switch record.quality {
+        case .excellent, .great:
+            bitrate = 40_000
+        case .good:
+            bitrate = 24_000
+        case .fair:
+            bitrate = 16_000
+        case .degraded:
+            bitrate = 8_000
+        case nil:
+            bitrate = nil
+        }
+        return PreflightVerdict(record: record, opusBitrate: bitrate, relayOnly: record.isTurnRequired)
+    }
+}
+
+// Verdicts keyed by network identity, valid for `window`. Persisted in
+// UserDefaults so a relaunch on the same network skips the preflight.
+final class PreflightCache {
+
+    let window:Duration
+    private let defaults:UserDefaults
+    private let entries:OSAllocatedUnfairLock<[String:PreflightVerdict]>
+
+    private static let defaultsKey = "PreflightCache.verdicts"
+
+    init(window:Duration = .seconds(30 * 60), defaults:UserDefaults = .standard) {
+        self.window = window
+        self.defaults = defaults
+        let stored = defaults.data(forKey: PreflightCache.defaultsKey).flatMap { try? JSONDecoder().decode([String:PreflightVerdict].self, from: $0) }
+        entries = OSAllocatedUnfairLock(initialState: stored ?? [:])
+    }
+
+    func verdict(for network:String, now:Date = Date()) -> PreflightVerdict? {
+        entries.withLock { entries in
+            guard let verdict = entries[network] else { return nil }
+            guard now.timeIntervalSince(verdict.record.completedAt) < window.timeInterval else {
+                entries[network] = nil
+                return nil
+            }
+            return verdict
+        }
+    }
+
+    func store(_ verdict:PreflightVerdict, for network:String) {
+        let snapshot = entries.withLock { entries in
+            entries[network] = verdict
+            return entries
+        }
+        if let data = try? JSONEncoder().encode(snapshot) {
+            defaults.set(data, forKey: PreflightCache.defaultsKey)
+        }
+    }
+}
+
+// Runs a Twilio preflight before the summary call unless the current network
+// already has a fresh verdict.
+final class PreflightService {
+
+    static let shared = PreflightService()
+
+    var policy = PreflightPolicy()
+    // A preflight takes about 10 s; past this the call goes ahead without one.
+    var deadline = Duration.seconds(15)
+    let cache:PreflightCache
+    private let monitor = NWPathMonitor()
+
+    init(cache:PreflightCache = PreflightCache()) {
+        self.cache = cache
+        monitor.start(queue: DispatchQueue(label: "PreflightService.path"))
+    }
+
+    deinit {
+        monitor.cancel()
+    }
+
+    // Interface type plus the gateway addresses, which tells home Wi-Fi from office Wi-Fi without location permission.
+    static func networkIdentity(for path:NWPath) -> String {
+        let interface = path.availableInterfaces.first.map { "\($0.type)" } ?? "none"
+        let gateways = path.gateways.map { "\($0)" }.sorted().joined(separator: ",")
+        return "\(interface)|\(gateways)"
+    }
+
+    var currentNetwork:String {
+        PreflightService.networkIdentity(for: monitor.currentPath)
+    }
+
+    // nil when the preflight timed out or failed for a reason the network did
+    // not cause; the call then goes ahead with the defaults and nothing is cached.
+    func verdict(accessToken:String) async -> PreflightVerdict? {
+        let network = currentNetwork
+        if let cached = cache.verdict(for: network) {
+            return cached
+        }
+        guard let record = await PreflightRun.run(accessToken: accessToken, deadline: deadline) else {
+            print("Preflight on \(network) gave no verdict, connecting with defaults")
+            return nil
+        }
+        IceConfigurationManager.shared.record(record)
+        let verdict = policy.verdict(for: record)
+        print("Preflight on \(network): quality \(record.quality.map { "\($0)" } ?? "unknown"), ice \(record.iceConnectionMilliseconds ?? 0) ms, relay \(verdict.relayOnly)")
+        cache.store(verdict, for: network)
+        return verdict
+    }
+}
+
+// Bridges PreflightDelegate to async. Keeps itself alive until the test ends
+// or the deadline passes. Callbacks and the deadline both run on `queue`.
+private final class PreflightRun:NSObject, PreflightDelegate {
+
+    private static let queue = DispatchQueue(label: "PreflightRun")
+
+    private var continuation:CheckedContinuation<PreflightRecord?, Never>?
+    private var test:PreflightTest?
+    private var retainedSelf:PreflightRun?
+
+    static func run(accessToken:String, deadline:Duration) async -> PreflightRecord? {
+        let run = PreflightRun()
+        return await withCheckedContinuation { continuation in
+            queue.async {
+                run.continuation = continuation
+                run.retainedSelf = run
+                let options = PreflightOptions(accessToken: accessToken) { builder in
+                    builder.delegateQueue = queue
+                    builder.preferredAudioCodecs = CallQualityController.shared.preferredAudioCodecs()
+                    builder.iceOptions = IceConfigurationManager.shared.iceOptions()
+                }
+                run.test = TwilioVoiceSDK.runPreflightTest(options: options, delegate: run)
+                queue.asyncAfter(deadline: .now() + deadline.timeInterval) {
+                    guard run.continuation != nil else { return }
+                    print("Preflight timed out after \(deadline)")
+                    run.test?.stop()
+                    run.finish(nil)
+                }
+            }
+        }
+    }
+
+    func preflightDidConnect(preflightTest: PreflightTest) {
+    }
+
+    func preflightDidComplete(preflightTest: PreflightTest, report: PreflightReport) {
+        finish(PreflightRecord(report: report))
+    }
+
+    func preflightDidFail(preflightTest: PreflightTest, error: Error) {
+        print("Preflight failed \(error.localizedDescription)")
+        finish(PreflightRecord.isNetworkFailure(error) ? PreflightRecord(completedAt: Date(), failed: true) : nil)
+    }
+
+    private func finish(_ record:PreflightRecord?) {
+        continuation?.resume(returning: record)
+        continuation = nil
+        test = nil
+        retainedSelf = nil
+    }
+}
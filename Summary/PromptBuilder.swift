@@ -0,0 +1,68 @@
+//
+//  PromptBuilder.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+// Assembles the ChatGPT prompt into a single reserved buffer as newline
+// separated records, with fields inside a record separated by "|". A "|" or
+// line break inside a field is replaced so it cannot split the record.
+struct PromptBuilder {
+
+    private(set) var text = ""
+
+    init(capacity:Int = 1024) {
+        text.reserveCapacity(capacity)
+    }
+
+    // Rough GPT tokenizer estimate of four UTF-8 bytes per token.
+    var estimatedTokens:Int {
+        PromptBuilder.estimateTokens(text)
+    }
+
+    static func estimateTokens(_ text:String) -> Int {
+        (text.utf8.count + 3) / 4
+    }
+
+    mutating func line(_ value:String) {
+        text.append(value)
+        text.append("\n")
+    }
+
+    mutating func record(_ fields:String...) {
+        for (index, field) in fields.enumerated() {
+            if index > 0 {
+                text.append("|")
+            }
+            // Fields are nearly always clean, so only those that need it are rebuilt.
+            if field.unicodeScalars.contains(where: { PromptBuilder.replacement(for: $0) != nil }) {
+                text.unicodeScalars.append(contentsOf: field.unicodeScalars.map { PromptBuilder.replacement(for: $0) ?? $0 })
+            } else {
+                text.append(field)
+            }
+        }
+        text.append("\n")
+    }
+
+    // "/" for the field separator and a space for anything read as a line break.
+    private static func replacement(for scalar:Unicode.Scalar) -> Unicode.Scalar? {
+        switch scalar {
+        case "|":
+            return "/"
+        case "\n"..."\r", "\u{85}", "\u{2028}", "\u{2029}":
+            return " "
+        default:
+            return nil
+        }
+    }
+
+    static func pounds(_ amount:Double) -> String {
+        "£" + String(format: "%.2f", amount)
+    }
+
+    static func pounds(minorUnits:Int) -> String {
+        pounds(Double(minorUnits) / 100)
+    }
+}
@@ -0,0 +1,83 @@
+//
+//  PromptCompactor.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+// Shrinks an account snapshot until its prompt fits a token budget. Repeated
+// mandates are always merged. A prompt that is still over budget keeps only
+// live mandates, its categories in descending order of spend with the tail
+// rolled into one "OTHER" entry, and if need be drops the latest upcoming debits.
+struct PromptCompactor {
+
+    var tokenBudget = 600
+    var liveStatus = "LIVE"
+
+    func compact(_ account:AccountSnapshot, using starling:StarlingService) -> AccountSnapshot {
+        var compacted = account
+        var seen = Set<String>()
+        compacted.directDebits.mandates = account.directDebits.mandates.filter { seen.insert("\($0.reference)\u{0}\($0.status)").inserted }
+        func fits() -> Bool {
+            starling.prompt(for: compacted).estimatedTokens <= tokenBudget
+        }
+        if fits() {
+            return compacted
+        }
+        let mandates = live(compacted.directDebits.mandates)
+        compacted.directDebits.mandates = mandates
+        let categories = account.spendings.breakdown.sorted { $0.totalSpent > $1.totalSpent }
+        compacted.spendings.breakdown = categories
+        if fits() {
+            return compacted
+        }
+        let keptCategories = largestFitting(below: categories.count) { keep in
+            compacted.spendings.breakdown = rollUp(categories, keeping: keep)
+            return fits()
+        }
+        compacted.spendings.breakdown = rollUp(categories, keeping: keptCategories)
+        if keptCategories > 0 || fits() {
+            return compacted
+        }
+        // Debits are listed soonest first, so the tail is the least urgent.
+        let keptMandates = largestFitting(below: mandates.count) { keep in
+            compacted.directDebits.mandates = Array(mandates.prefix(keep))
+            return fits()
+        }
+        compacted.directDebits.mandates = Array(mandates.prefix(keptMandates))
+        return compacted
+    }
+
+    // Largest count under `limit` for which `fits` holds, found by binary search;
+    // zero when none does.
+    private func largestFitting(below limit:Int, _ fits:(Int) -> Bool) -> Int {
+        var low = 0
+        var high = limit - 1
+        var best = 0
+        while low <= high {
+            let keep = (low + high) / 2
+            if fits(keep) {
+                best = keep
+                low = keep + 1
+            } else {
+                high = keep - 1
+            }
+        }
+        return best
+    }
+
+    private func rollUp(_ categories:[Category], keeping count:Int) -> [Category] {
+        guard count < categories.count else { return categories }
+        var kept = Array(categories.prefix(count))
+        let other = categories.dropFirst(count).reduce(0) { $0 + $1.totalSpent }
+        kept.append(Category(spendingCategory: "OTHER", totalSpent: other))
+        return kept
+    }
+
+    // Only live mandates become upcoming debits, and each reference is listed once.
+    private func live(_ mandates:[Mandate]) -> [Mandate] {
+        var seen = Set<String>()
+        return mandates.filter { $0.status == liveStatus && seen.insert($0.reference).inserted }
+    }
+}
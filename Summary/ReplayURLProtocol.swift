@@ -0,0 +1,115 @@
+//
+//  ReplayURLProtocol.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import os
+
+// Local stand-in for the Starling, OpenAI and Twilio servers. Requests whose URL
+// contains a registered fragment, and whose Accept header matches the route's,
+// are answered with the recorded response after the configured latency, plus
+// any per-KiB latency for the request body, or failed at the configured rate.
+// Install it with `ReplayURLProtocol.configuration()` when building a NetworkClient.
+final class ReplayURLProtocol:URLProtocol {
+
+    struct Route {
+        var status = 200
+        var headers = ["Content-Type": "application/json"]
+        var body:Data
+        var latency:TimeInterval = 0
+        var failureRate = 0.0
+        // Added per KiB of request body, e.g. for a model's prompt processing.
+        var latencyPerKiB:TimeInterval = 0
+        // Set for streaming routes, so one endpoint can answer both kinds of request.
+        var accept:String?
+        // Sent as the ETag header; a request whose If-None-Match matches gets an empty 304.
+        var etag:String?
+    }
+
+    private static let routes = OSAllocatedUnfairLock(initialState: [(fragment:String, route:Route)]())
+
+    private var pending:DispatchWorkItem?
+
+    static func register(_ route:Route, forURLContaining fragment:String) {
+        routes.withLock { $0.append((fragment, route)) }
+    }
+
+    static func reset() {
+        routes.withLock { $0.removeAll() }
+    }
+
+    static func configuration(base:URLSessionConfiguration = NetworkClient.defaultConfiguration()) -> URLSessionConfiguration {
+        base.protocolClasses = [ReplayURLProtocol.self] + (base.protocolClasses ?? [])
+        base.urlCache = nil
+        return base
+    }
+
+    private static func route(for request:URLRequest) -> Route? {
+        guard let url = request.url?.absoluteString else { return nil }
+        let accept = request.value(forHTTPHeaderField: "Accept")
+        return routes.withLock { routes in
+            routes.first { url.contains($0.fragment) && $0.route.accept == accept }?.route
+        }
+    }
+
+    override class func canInit(with request: URLRequest) -> Bool {
+        route(for: request) != nil
+    }
+
+    override class func canonicalRequest(for request: URLRequest) -> URLRequest {
+        request
+    }
+
+    override func startLoading() {
+        guard let route = ReplayURLProtocol.route(for: request), let url = request.url else {
+            client?.urlProtocol(self, didFailWithError: URLError(.unsupportedURL))
+            return
+        }
+        let work = DispatchWorkItem { [weak self] in
+            guard let self else { return }
+            if Double.random(in: 0..<1) < route.failureRate {
+                self.client?.urlProtocol(self, didFailWithError: URLError(.networkConnectionLost))
+                return
+            }
+            var headers = route.headers
+            var status = route.status
+            if let etag = route.etag {
+                headers["ETag"] = etag
+                if self.request.value(forHTTPHeaderField: "If-None-Match") == etag {
+                    status = 304
+                }
+            }
+            let response = HTTPURLResponse(url: url, statusCode: status, httpVersion: "HTTP/2", headerFields: headers)!
+            self.client?.urlProtocol(self, didReceive: response, cacheStoragePolicy: .notAllowed)
+            if status != 304 {
+                self.client?.urlProtocol(self, didLoad: route.body)
+            }
+            self.client?.urlProtocolDidFinishLoading(self)
+        }
+        pending = work
+        let latency = route.latency + route.latencyPerKiB * Double(ReplayURLProtocol.bodyLength(of: request)) / 1024
+        DispatchQueue.global().asyncAfter(deadline: .now() + latency, execute: work)
+    }
+
+    // URLSession hands protocols the body as a stream rather than httpBody.
+    private static func bodyLength(of request:URLRequest) -> Int {
+        if let body = request.httpBody {
+            return body.count
+        }
+        guard let stream = request.httpBodyStream else { return 0 }
+        stream.open()
+        defer { stream.close() }
+        var length = 0
+        var buffer = [UInt8](repeating: 0, count: 4096)
+        while case let read = stream.read(&buffer, maxLength: buffer.count), read > 0 {
+            length += read
+        }
+        return length
+    }
+
+    override func stopLoading() {
+        pending?.cancel()
+    }
+}
@@ -0,0 +1,486 @@
+//
+//  RingBufferAudioDevice.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import AVFoundation
+import AudioToolbox
+import Synchronization
+import TwilioVoice
+
+// Custom TwilioVoice audio device built on a VoiceProcessingIO unit. The audio
+// unit callbacks only move samples between the unit and two pre-allocated
+// SPSC rings: no locks, no allocation, no Objective-C. A separate pump queue
+// exchanges whole `framesPerBuffer` chunks between the rings and the SDK via
+// AudioDeviceWriteCaptureData / AudioDeviceReadRenderData.
+final class RingBufferAudioDevice:NSObject, AudioDevice {
+
+    // Everything the real-time callbacks touch. Allocated before the unit starts
+    // and only released after it has been disposed.
+    fileprivate final class RealtimeState {
+        let renderRing:SPSCRingBuffer
+        let captureRing:SPSCRingBuffer
+        let captureBufferList:UnsafeMutableAudioBufferListPointer
+        let captureSamples:UnsafeMutablePointer<Int16>
+        let maxFrames:Int
+        let channels:Int
+        // Written on pumpQueue, read by the capture callback while the unit runs.
+        let audioUnit = Atomic<AudioUnit?>(nil)
+        let renderUnderruns = Atomic<Int>(0)
+        let captureOverruns = Atomic<Int>(0)
+        let renderProfiler:AudioCallbackProfiler
+        let captureProfiler:AudioCallbackProfiler
+
+        init(format:AudioFormat) {
+            channels = format.numberOfChannels
+            maxFrames = max(4096, format.framesPerBuffer * 4)
+            let ringSamples = format.framesPerBuffer * format.numberOfChannels * 8
+            renderRing = SPSCRingBuffer(minimumCapacity: ringSamples)
+            captureRing = SPSCRingBuffer(minimumCapacity: ringSamples)
+            captureSamples = .allocate(capacity: maxFrames * channels)
+            captureSamples.initialize(repeating: 0, count: maxFrames * channels)
+            var bufferList = AudioBufferList.allocate(maximumBuffers: 1)
+            bufferList[0] = AudioBuffer(mNumberChannels: UInt32(channels),
+                                        mDataByteSize: UInt32(maxFrames * channels * MemoryLayout<Int16>.size),
+                                        mData: UnsafeMutableRawPointer(captureSamples))
+            captureBufferList = bufferList
+            renderProfiler = AudioCallbackProfiler(name: "render", framesPerBuffer: format.framesPerBuffer, sampleRate: Int(format.sampleRate))
+            captureProfiler = AudioCallbackProfiler(name: "capture", framesPerBuffer: format.framesPerBuffer, sampleRate: Int(format.sampleRate))
+        }
+
+        deinit {
+            free(captureBufferList.unsafeMutablePointer)
+            captureSamples.deallocate()
+        }
+
+        // Capture half of the callback once captureSamples holds `count` new samples.
+        @inline(__always)
+        func storeCaptured(count:Int) {
+            if captureRing.write(captureSamples, count: count) < count {
+                _ = captureOverruns.wrappingAdd(1, ordering: .relaxed)
+            }
+        }
+    }
+
+    let format:AudioFormat
+    // When set, capture is delegated to this capturer instead of the microphone.
+    let capturer:(any AudioDeviceCapturer)?
+    let captureMeter = AudioLevelMeter()
+    private let state:RealtimeState
+    private let pumpQueue = DispatchQueue(label: "RingBufferAudioDevice.pump", qos: .userInteractive)
+    private let pumpBuffer:UnsafeMutablePointer<Int16>
+    // The fields below are only touched on pumpQueue.
+    private var pumpTimer:DispatchSourceTimer?
+    private var renderContext:AudioDeviceContext?
+    private var captureContext:AudioDeviceContext?
+    private var scheduler:AudioWorkerScheduler!
+    private var observers = [NSObjectProtocol]()
+
+    init(format:AudioFormat = RingBufferAudioDevice.preferredFormat(), capturer:(any AudioDeviceCapturer)? = nil) {
+        self.format = format
+        self.capturer = capturer
+        state = RealtimeState(format: format)
+        pumpBuffer = .allocate(capacity: format.framesPerBuffer * format.numberOfChannels)
+        pumpBuffer.initialize(repeating: 0, count: format.framesPerBuffer * format.numberOfChannels)
+        super.init()
+        scheduler = AudioWorkerScheduler { [weak self] events, context in
+            self?.handleWorkerEvents(events, context: context)
+        }
+        observeAudioSession()
+    }
+
+    deinit {
+        for observer in observers {
+            NotificationCenter.default.removeObserver(observer)
+        }
+        pumpTimer?.cancel()
+        disposeAudioUnit()
+        pumpBuffer.deallocate()
+    }
+
+    static func preferredFormat() -> AudioFormat {
+        // 48 kHz mono in 10 ms buffers.
+        let sampleRate = AudioFormat.SampleRate48000
+        return AudioFormat(channels: AudioFormat.ChannelsMono, sampleRate: sampleRate, framesPerBuffer: Int(sampleRate) / 100)!
+    }
+
+    var renderUnderruns:Int {
+        state.renderUnderruns.load(ordering: .relaxed)
+    }
+
+    var captureOverruns:Int {
+        state.captureOverruns.load(ordering: .relaxed)
+    }
+
+    // Callback timing for the audio unit, plus the capturer's when it is profiled too.
+    var callbackReports:[AudioCallbackProfiler.Report] {
+        var reports = [state.renderProfiler.report()]
+        if let capturer = capturer as? SummaryPlaybackCapturer {
+            reports.append(capturer.profiler.report())
+        } else {
+            reports.append(state.captureProfiler.report())
+        }
+        return reports
+    }
+
+    // MARK: AudioDeviceRenderer
+
+    func renderFormat() -> AudioFormat? {
+        format
+    }
+
+    func initializeRenderer() -> Bool {
+        true
+    }
+
+    func startRendering(_ context: AudioDeviceContext) -> Bool {
+        pumpQueue.sync {
+            renderContext = context
+            scheduler.context = context
+            return startIfNeeded()
+        }
+    }
+
+    func stopRendering() -> Bool {
+        pumpQueue.sync {
+            renderContext = nil
+            scheduler.context = nil
+            stopIfIdle()
+            return true
+        }
+    }
+
+    // MARK: AudioDeviceCapturer
+
+    func captureFormat() -> AudioFormat? {
+        capturer?.captureFormat() ?? format
+    }
+
+    func initializeCapturer() -> Bool {
+        capturer?.initializeCapturer() ?? true
+    }
+
+    func startCapturing(_ context: AudioDeviceContext) -> Bool {
+        if let capturer {
+            return capturer.startCapturing(context)
+        }
+        return pumpQueue.sync {
+            captureContext = context
+            return startIfNeeded()
+        }
+    }
+
+    func stopCapturing() -> Bool {
+        if let capturer {
+            return capturer.stopCapturing()
+        }
+        return pumpQueue.sync {
+            captureContext = nil
+            captureMeter.reset()
+            stopIfIdle()
+            return true
+        }
+    }
+
+    // MARK: Pump
+
+    private func startIfNeeded() -> Bool {
+        if state.audioUnit.load(ordering: .relaxed) != nil {
+            return true
+        }
+        guard configureAudioSession(), createAudioUnit() else {
+            disposeAudioUnit()
+            return false
+        }
+        let timer = DispatchSource.makeTimerSource(flags: .strict, queue: pumpQueue)
+        let interval = Double(format.framesPerBuffer) / Double(format.sampleRate)
+        timer.schedule(deadline: .now(), repeating: interval / 2, leeway: .microseconds(500))
+        timer.setEventHandler { [weak self] in
+            self?.pump()
+        }
+        pumpTimer = timer
+        timer.resume()
+        guard let unit = state.audioUnit.load(ordering: .relaxed), AudioOutputUnitStart(unit) == noErr else {
+            stopIfIdle(force: true)
+            return false
+        }
+        return true
+    }
+
+    private func stopIfIdle(force:Bool = false) {
+        guard force || (renderContext == nil && captureContext == nil) else { return }
+        pumpTimer?.cancel()
+        pumpTimer = nil
+        disposeAudioUnit()
+        state.renderRing.reset()
+        state.captureRing.reset()
+    }
+
+    private func pump() {
+        let chunk = format.framesPerBuffer * format.numberOfChannels
+        let bytes = chunk * MemoryLayout<Int16>.size
+        if let captureContext {
+            while state.captureRing.availableToRead >= chunk {
+                state.captureRing.read(into: pumpBuffer, count: chunk)
+                captureMeter.measure(pumpBuffer, count: chunk)
+                pumpBuffer.withMemoryRebound(to: Int8.self, capacity: bytes) { data in
+                    AudioDeviceWriteCaptureData(context: captureContext, data: data, sizeInBytes: bytes)
+                }
+            }
+        }
+        if let renderContext {
+            // Keep two buffers queued ahead of the render callback.
+            while state.renderRing.availableToRead < chunk * 2 && state.renderRing.availableToWrite >= chunk {
+                pumpBuffer.withMemoryRebound(to: Int8.self, capacity: bytes) { data in
+                    AudioDeviceReadRenderData(context: renderContext, data: data, sizeInBytes: bytes)
+                }
+                state.renderRing.write(pumpBuffer, count: chunk)
+            }
+        }
+    }
+
+    // MARK: Audio session events
+
+    var workerStats:AudioWorkerScheduler.Stats {
+        scheduler.stats
+    }
+
+    private func observeAudioSession() {
+        let center = NotificationCenter.default
+        let session = AVAudioSession.sharedInstance()
+        observers.append(center.addObserver(forName: AVAudioSession.interruptionNotification, object: session, queue: nil) { [weak self] notification in
+            guard let rawType = notification.userInfo?[AVAudioSessionInterruptionTypeKey] as? UInt,
+                  let type = AVAudioSession.InterruptionType(rawValue: rawType) else { return }
+            self?.scheduler.post(type == .began ? .interruptionBegan : .interruptionEnded)
+        })
+        observers.append(center.addObserver(forName: AVAudioSession.routeChangeNotification, object: session, queue: nil) { [weak self] notification in
+            guard let rawReason = notification.userInfo?[AVAudioSessionRouteChangeReasonKey] as? UInt,
+                  let reason = AVAudioSession.RouteChangeReason(rawValue: rawReason) else { return }
+            switch reason {
+            case .newDeviceAvailable, .oldDeviceUnavailable, .categoryChange, .override, .routeConfigurationChange:
+                self?.scheduler.post(.reinitialize)
+            default:
+                break
+            }
+        })
+        observers.append(center.addObserver(forName: AVAudioSession.mediaServicesWereResetNotification, object: session, queue: nil) { [weak self] _ in
+            self?.scheduler.post(.reinitialize)
+        })
+    }
+
+    // Runs on the SDK's audio worker thread. The unit is stopped or restarted on
+    // pumpQueue without blocking the worker, and the SDK is told afterwards back
+    // on the worker, so the pump never waits on the worker while it waits here.
+    private func handleWorkerEvents(_ events:AudioWorkerScheduler.Events, context:AudioDeviceContext) {
+        pumpQueue.async { [weak self] in
+            // The device may have been stopped, or restarted with a new context, since.
+            guard let self, renderContext == context else { return }
+            let unit = state.audioUnit.load(ordering: .relaxed)
+            if events.contains(.interruptionBegan), let unit {
+                AudioOutputUnitStop(unit)
+            }
+            let activated:Bool
+            if events.contains(.interruptionEnded), let unit {
+                activated = restart(unit)
+            } else {
+                activated = false
+            }
+            AudioDeviceExecuteWorkerBlock(context: context) {
+                if events.contains(.interruptionBegan) {
+                    AudioSessionDeactivated(context: context)
+                }
+                if events.contains(.reinitialize) {
+                    AudioDeviceReinitialize(context: context)
+                }
+                if activated {
+                    AudioSessionActivated(context: context)
+                }
+            }
+        }
+    }
+
+    private func restart(_ unit:AudioUnit) -> Bool {
+        do {
+            try AVAudioSession.sharedInstance().setActive(true)
+        } catch {
+            print("Failed to reactivate audio session \(error.localizedDescription)")
+            return false
+        }
+        return AudioOutputUnitStart(unit) == noErr
+    }
+
+    // MARK: Audio unit
+
+    private func configureAudioSession() -> Bool {
+        let session = AVAudioSession.sharedInstance()
+        do {
+            try session.setCategory(.playAndRecord, mode: .voiceChat, options: [.allowBluetooth])
+            try session.setPreferredSampleRate(Double(format.sampleRate))
+            try session.setPreferredIOBufferDuration(Double(format.framesPerBuffer) / Double(format.sampleRate))
+            try session.setActive(true)
+            return true
+        } catch {
+            print("Failed to configure audio session \(error.localizedDescription)")
+            return false
+        }
+    }
+
+    private func createAudioUnit() -> Bool {
+        var description = AudioComponentDescription(componentType: kAudioUnitType_Output,
+                                                    componentSubType: kAudioUnitSubType_VoiceProcessingIO,
+                                                    componentManufacturer: kAudioUnitManufacturer_Apple,
+                                                    componentFlags: 0,
+                                                    componentFlagsMask: 0)
+        guard let component = AudioComponentFindNext(nil, &description) else { return false }
+        var audioUnit:AudioUnit?
+        guard AudioComponentInstanceNew(component, &audioUnit) == noErr, let unit = audioUnit else { return false }
+        state.audioUnit.store(unit, ordering: .releasing)
+
+        let outputBus:AudioUnitElement = 0
+        let inputBus:AudioUnitElement = 1
+        var enable:UInt32 = 1
+        var streamDescription = format.streamDescription()
+        let refCon = Unmanaged.passUnretained(state).toOpaque()
+        var renderCallbackStruct = AURenderCallbackStruct(inputProc: renderCallback, inputProcRefCon: refCon)
+        var captureCallbackStruct = AURenderCallbackStruct(inputProc: captureCallback, inputProcRefCon: refCon)
+
+        var statuses = [
+            AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Input, outputBus,
+                                 &streamDescription, UInt32(MemoryLayout<AudioStreamBasicDescription>.size)),
+            AudioUnitSetProperty(unit, kAudioUnitProperty_SetRenderCallback, kAudioUnitScope_Input, outputBus,
+                                 &renderCallbackStruct, UInt32(MemoryLayout<AURenderCallbackStruct>.size))
+        ]
+        // The microphone is only opened when no capturer replaces it.
+        if capturer == nil {
+            statuses += [
+                AudioUnitSetProperty(unit, kAudioOutputUnitProperty_EnableIO, kAudioUnitScope_Input, inputBus,
+                                     &enable, UInt32(MemoryLayout<UInt32>.size)),
+                AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Output, inputBus,
+                                     &streamDescription, UInt32(MemoryLayout<AudioStreamBasicDescription>.size)),
+                AudioUnitSetProperty(unit, kAudioOutputUnitProperty_SetInputCallback, kAudioUnitScope_Global, inputBus,
+                                     &captureCallbackStruct, UInt32(MemoryLayout<AURenderCallbackStruct>.size))
+            ]
+        }
+        statuses.append(AudioUnitInitialize(unit))
+        if let failure = statuses.first(where: { $0 != noErr }) {
+            print("Failed to set up audio unit \(failure)")
+            return false
+        }
+        return true
+    }
+
+    private func disposeAudioUnit() {
+        guard let unit = state.audioUnit.load(ordering: .relaxed) else { return }
+        // Once stopped no callback can still be reading the unit.
+        AudioOutputUnitStop(unit)
+        state.audioUnit.store(nil, ordering: .releasing)
+        AudioUnitUninitialize(unit)
+        AudioComponentInstanceDispose(unit)
+    }
+}
+
+private let renderCallback:AURenderCallback = { refCon, _, _, _, frames, ioData in
+    guard let ioData else { return noErr }
+    return Unmanaged<RingBufferAudioDevice.RealtimeState>.fromOpaque(refCon)._withUnsafeGuaranteedRef { state in
+        let start = state.renderProfiler.begin()
+        defer { state.renderProfiler.end(start) }
+        let buffer = ioData.pointee.mBuffers
+        guard let data = buffer.mData else { return noErr }
+        let samples = data.assumingMemoryBound(to: Int16.self)
+        let wanted = min(Int(frames) * state.channels, Int(buffer.mDataByteSize) / MemoryLayout<Int16>.size)
+        let read = state.renderRing.read(into: samples, count: wanted)
+        if read < wanted {
+            (samples + read).update(repeating: 0, count: wanted - read)
+            _ = state.renderUnderruns.wrappingAdd(1, ordering: .relaxed)
+        }
+        return noErr
+    }
+}
+
+private let captureCallback:AURenderCallback = { refCon, flags, timestamp, bus, frames, _ in
+    Unmanaged<RingBufferAudioDevice.RealtimeState>.fromOpaque(refCon)._withUnsafeGuaranteedRef { state in
+        guard let unit = state.audioUnit.load(ordering: .acquiring), Int(frames) <= state.maxFrames else { return noErr }
+        let start = state.captureProfiler.begin()
+        defer { state.captureProfiler.end(start) }
+        let count = Int(frames) * state.channels
+        state.captureBufferList.unsafeMutablePointer.pointee.mBuffers.mDataByteSize = UInt32(count * MemoryLayout<Int16>.size)
+        let status = AudioUnitRender(unit, flags, timestamp, bus, frames, state.captureBufferList.unsafeMutablePointer)
+        guard status == noErr else { return status }
+        state.storeCaptured(count: count)
+        return noErr
+    }
+}
+
+#if DEBUG
+extension RingBufferAudioDevice {
+
+    // Drives the real-time callbacks and rings without an audio unit or an SDK
+    // context, so AudioKernelBenchmark can feed synthetic PCM on the host and
+    // count xruns. The harness plays the pump's part through the rings.
+    final class Harness {
+
+        let format:AudioFormat
+        private let state:RealtimeState
+        private let renderBufferList:UnsafeMutableAudioBufferListPointer
+        private let renderSamples:UnsafeMutablePointer<Int16>
+        private let flags = UnsafeMutablePointer<AudioUnitRenderActionFlags>.allocate(capacity: 1)
+        private let timestamp = UnsafeMutablePointer<AudioTimeStamp>.allocate(capacity: 1)
+
+        init(format:AudioFormat) {
+            self.format = format
+            state = RealtimeState(format: format)
+            renderSamples = .allocate(capacity: state.maxFrames * state.channels)
+            renderSamples.initialize(repeating: 0, count: state.maxFrames * state.channels)
+            renderBufferList = AudioBufferList.allocate(maximumBuffers: 1)
+            flags.initialize(to: [])
+            timestamp.initialize(to: AudioTimeStamp())
+        }
+
+        deinit {
+            free(renderBufferList.unsafeMutablePointer)
+            renderSamples.deallocate()
+            flags.deallocate()
+            timestamp.deallocate()
+        }
+
+        var renderRing:SPSCRingBuffer {
+            state.renderRing
+        }
+
+        var captureRing:SPSCRingBuffer {
+            state.captureRing
+        }
+
+        var renderUnderruns:Int {
+            state.renderUnderruns.load(ordering: .relaxed)
+        }
+
+        var captureOverruns:Int {
+            state.captureOverruns.load(ordering: .relaxed)
+        }
+
+        var maxFrames:Int {
+            state.maxFrames
+        }
+
+        // Runs the render callback for `frames` hardware frames and returns what it played.
+        func render(frames:Int) -> UnsafeBufferPointer<Int16> {
+            let count = min(frames, state.maxFrames) * state.channels
+            renderBufferList[0] = AudioBuffer(mNumberChannels: UInt32(state.channels),
+                                              mDataByteSize: UInt32(count * MemoryLayout<Int16>.size),
+                                              mData: UnsafeMutableRawPointer(renderSamples))
+            _ = renderCallback(Unmanaged.passUnretained(state).toOpaque(), flags, timestamp, 0, UInt32(frames), renderBufferList.unsafeMutablePointer)
+            return UnsafeBufferPointer(start: renderSamples, count: count)
+        }
+
+        // Runs the capture half of the callback with `fill` standing in for AudioUnitRender.
+        func capture(frames:Int, _ fill:(UnsafeMutablePointer<Int16>, Int) -> Void) {
+            let count = min(frames, state.maxFrames) * state.channels
+            fill(state.captureSamples, count)
+            state.storeCaptured(count: count)
+        }
+    }
+}
+#endif
@@ -0,0 +1,87 @@
+//
+//  SPSCRingBuffer.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import Synchronization
+
+// Single-producer/single-consumer ring of int16 samples. Storage is allocated
+// once in init; `write` and `read` never lock or allocate, so one side can run
+// on a real-time audio thread. Indices grow monotonically and are masked into
+// the power-of-two storage.
+final class SPSCRingBuffer {
+
+    let capacity:Int
+    private let mask:Int
+    private let storage:UnsafeMutablePointer<Int16>
+    private let head = Atomic<Int>(0)
+    private let tail = Atomic<Int>(0)
+
+    init(minimumCapacity:Int) {
+        var capacity = 1
+        while capacity < minimumCapacity {
+            capacity <<= 1
+        }
+        self.capacity = capacity
+        mask = capacity - 1
+        storage = .allocate(capacity: capacity)
+        storage.initialize(repeating: 0, count: capacity)
+    }
+
+    deinit {
+        storage.deallocate()
+    }
+
+    // Safe to call from either side; the value may be stale by the time it is used.
+    var availableToRead:Int {
+        head.load(ordering: .acquiring) - tail.load(ordering: .acquiring)
+    }
+
+    var availableToWrite:Int {
+        capacity - availableToRead
+    }
+
+    // Producer side. Returns the number of samples written, which is less than
+    // `count` when the ring is full.
+    @discardableResult
+    func write(_ samples:UnsafePointer<Int16>, count:Int) -> Int {
+        let writeIndex = head.load(ordering: .relaxed)
+        let readIndex = tail.load(ordering: .acquiring)
+        let written = min(count, capacity - (writeIndex - readIndex))
+        guard written > 0 else { return 0 }
+        let start = writeIndex & mask
+        let firstPart = min(written, capacity - start)
+        (storage + start).update(from: samples, count: firstPart)
+        if written > firstPart {
+            storage.update(from: samples + firstPart, count: written - firstPart)
+        }
+        head.store(writeIndex + written, ordering: .releasing)
+        return written
+    }
+
+    // Consumer side. Returns the number of samples read, which is less than
+    // `count` when the ring runs dry.
+    @discardableResult
+    func read(into samples:UnsafeMutablePointer<Int16>, count:Int) -> Int {
+        let readIndex = tail.load(ordering: .relaxed)
+        let writeIndex = head.load(ordering: .acquiring)
+        let read = min(count, writeIndex - readIndex)
+        guard read > 0 else { return 0 }
+        let start = readIndex & mask
+        let firstPart = min(read, capacity - start)
+        samples.update(from: storage + start, count: firstPart)
+        if read > firstPart {
+            (samples + firstPart).update(from: storage, count: read - firstPart)
+        }
+        tail.store(readIndex + read, ordering: .releasing)
+        return read
+    }
+
+    // Only valid while neither side is running.
+    func reset() {
+        head.store(0, ordering: .relaxed)
+        tail.store(0, ordering: .relaxed)
+    }
+}
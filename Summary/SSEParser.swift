@@ -0,0 +1,99 @@
+//
+//  SSEParser.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+struct SSEEvent {
+    var event:String?
+    var data:String
+}
+
+// Incremental server-sent events parser. Bytes can be pushed as they arrive
+// from the network, or a whole recorded stream can be parsed at once.
+struct SSEParser {
+
+    private var line = [UInt8]()
+    private var event:String?
+    private var data = [String]()
+    private var lastWasCarriageReturn = false
+
+    mutating func consume(_ byte: UInt8) -> SSEEvent? {
+        if byte == UInt8(ascii: "\n") && lastWasCarriageReturn {
+            lastWasCarriageReturn = false
+            return nil
+        }
+        lastWasCarriageReturn = byte == UInt8(ascii: "\r")
+        if byte == UInt8(ascii: "\n") || byte == UInt8(ascii: "\r") {
+            return endLine()
+        }
+        line.append(byte)
+        return nil
+    }
+
+    mutating func finish() -> SSEEvent? {
+        if !line.isEmpty, let event = endLine() {
+            return event
+        }
+        return dispatch()
+    }
+
+    static func parse(_ data: Data) -> [SSEEvent] {
+        var parser = SSEParser()
+        var events = [SSEEvent]()
+        for byte in data {
+            if let event = parser.consume(byte) {
+                events.append(event)
+            }
+        }
+        if let event = parser.finish() {
+            events.append(event)
+        }
+        return events
+    }
+
+    private mutating func endLine() -> SSEEvent? {
+        defer { line.removeAll(keepingCapacity: true) }
+        if line.isEmpty {
+            return dispatch()
+        }
+        if line.first == UInt8(ascii: ":") {
+            return nil
+        }
+        let field:String
+        let value:String
+        if let colon = line.firstIndex(of: UInt8(ascii: ":")) {
+            field = String(decoding: line[..<colon], as: UTF8.self)
+            var valueStart = line.index(after: colon)
+            if valueStart < line.endIndex && line[valueStart] == UInt8(ascii: " ") {
+                valueStart = line.index(after: valueStart)
+            }
+            value = String(decoding: line[valueStart...], as: UTF8.self)
+        } else {
+            field = String(decoding: line, as: UTF8.self)
+            value = ""
+        }
+        switch field {
+        case "event":
+            event = value
+        case "data":
+            data.append(value)
+        default:
+            break
+        }
+        return nil
+    }
+
+    private mutating func dispatch() -> SSEEvent? {
+        defer {
+            event = nil
+            data.removeAll()
+        }
+        if data.isEmpty {
+            return nil
+        }
+        return SSEEvent(event: event, data: data.joined(separator: "\n"))
+    }
+}
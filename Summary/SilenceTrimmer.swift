@@ -0,0 +1,153 @@
+//
+//  SilenceTrimmer.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+// Streaming silence trimmer for interleaved int16 audio. Input is analysed in
+// windows of one device buffer using the SIMD RMS kernel from AudioLevelMeter.
+// Voiced windows pass through as views of the input. Silent windows are held
+// back and only emitted if speech follows. This drops leading and trailing
+// silence and shortens long pauses, keeping a short pre-roll and tail so words
+// are not clipped.
+final class SilenceTrimmer {
+
+    struct Options {
+        // Windows with RMS below this level, relative to int16 full scale, count as silence (about -46 dBFS).
+        var threshold:Float = 0.005
+        var preRoll = Duration.milliseconds(60)
+        var tail = Duration.milliseconds(150)
+        var maximumPause = Duration.milliseconds(400)
+    }
+
+    struct Stats {
+        var sampleRate:Int
+        var channels:Int
+        var inputSamples = 0
+        var leadingTrimmed = 0
+        var pauseTrimmed = 0
+        var trailingTrimmed = 0
+
+        var trimmedSamples:Int {
+            leadingTrimmed + pauseTrimmed + trailingTrimmed
+        }
+
+        var trimmedDuration:Duration {
+            duration(trimmedSamples)
+        }
+
+        var inputDuration:Duration {
+            duration(inputSamples)
+        }
+
+        private func duration(_ samples:Int) -> Duration {
+            .microseconds(Int64(samples / channels) * 1_000_000 / Int64(sampleRate))
+        }
+    }
+
+    typealias Emit = (UnsafePointer<Int16>, Int) throws -> Void
+
+    let options:Options
+    private(set) var stats:Stats
+    private let windowSamples:Int
+    private let preRollSamples:Int
+    private let tailSamples:Int
+    private let pauseSamples:Int
+    private let held:UnsafeMutablePointer<Int16>
+    private let heldCapacity:Int
+    private var heldCount = 0
+    private var heldDropped = 0
+    private var voiced = false
+
+    init(sampleRate:Int, channels:Int, framesPerBuffer:Int, options:Options = Options()) {
+        self.options = options
+        stats = Stats(sampleRate: sampleRate, channels: channels)
+        func samples(_ duration:Duration) -> Int {
+            Int(duration.timeInterval * Double(sampleRate)) * channels
+        }
+        windowSamples = framesPerBuffer * channels
+        preRollSamples = samples(options.preRoll)
+        tailSamples = samples(options.tail)
+        pauseSamples = samples(options.maximumPause)
+        heldCapacity = max(preRollSamples, pauseSamples) + windowSamples
+        held = .allocate(capacity: heldCapacity)
+        held.initialize(repeating: 0, count: heldCapacity)
+    }
+
+    deinit {
+        held.deallocate()
+    }
+
+    // Feeds the next chunk. `emit` receives the audio to keep, in order; each
+    // pointer is only valid during the call.
+    func consume(_ samples:UnsafePointer<Int16>, count:Int, emit:Emit) rethrows {
+        stats.inputSamples += count
+        var offset = 0
+        while offset < count {
+            let length = min(windowSamples, count - offset)
+            let window = samples + offset
+            if AudioLevelMeter.level(of: window, count: length).rms >= options.threshold {
+                try flushHeld(emit: emit)
+                voiced = true
+                try emit(window, length)
+            } else {
+                hold(window, count: length)
+            }
+            offset += length
+        }
+    }
+
+    // Ends the stream: keeps the tail of the trailing silence and drops the rest.
+    func finish(emit:Emit) rethrows {
+        if voiced {
+            let kept = min(heldCount, tailSamples)
+            if kept > 0 {
+                try emit(held, kept)
+            }
+            stats.trailingTrimmed += heldCount - kept + heldDropped
+        } else {
+            stats.leadingTrimmed += heldCount + heldDropped
+        }
+        heldCount = 0
+        heldDropped = 0
+        voiced = false
+    }
+
+    private func hold(_ window:UnsafePointer<Int16>, count:Int) {
+        if !voiced {
+            // Before the first word only the most recent pre-roll is worth keeping.
+            let total = heldCount + count
+            let keep = min(total, preRollSamples)
+            let dropped = total - keep
+            if dropped >= heldCount {
+                held.update(from: window + (dropped - heldCount), count: keep)
+            } else {
+                memmove(held, held + dropped, (heldCount - dropped) * MemoryLayout<Int16>.size)
+                (held + heldCount - dropped).update(from: window, count: count)
+            }
+            stats.leadingTrimmed += dropped
+            heldCount = keep
+            return
+        }
+        // Inside speech, keep up to the maximum pause and drop the rest.
+        let kept = min(count, pauseSamples - heldCount)
+        if kept > 0 {
+            (held + heldCount).update(from: window, count: kept)
+            heldCount += kept
+        }
+        heldDropped += count - kept
+    }
+
+    private func flushHeld(emit:Emit) rethrows {
+        if heldCount > 0 {
+            try emit(held, heldCount)
+        }
+        if voiced {
+            stats.pauseTrimmed += heldDropped
+        }
+        heldCount = 0
+        heldDropped = 0
+    }
+}
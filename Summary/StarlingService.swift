@@ -6,58 +6,186 @@
 //
 import Foundation
 
+struct FetchTimings: CustomStringConvertible {
+    var balance: Duration = .zero
+    var spendings: Duration = .zero
+    var directDebits: Duration = .zero
+    var total: Duration = .zero
+
+    var description: String {
+        "balance \(balance), spendings \(spendings), direct debits \(directDebits), total \(total)"
+    }
+}
+
 struct StarlingService {
-    
+
+    var baseURL = URL(string: "https://api-sandbox.starlingbank.com/api/v2")!
+    var accountUid = "<ACCOUNT UID>"
+    var customerName = "Mike"
+    // Deadline applied to each endpoint on its own, not to the whole fetch.
+    var requestTimeout: Duration = .seconds(10)
+    var session = NetworkClient.shared.session
+    var validators = ValidatorStore()
     private var accessToken = "Bearer STARLING ACCESS TOKEN"
-    
-    func fetchSummary()async throws -> String {
-        var summary = "Hello Mike, hope you are doing great. We would like to provide a quick summary of your account and remind you of upcoming debits."
-        let balance = try await fetchBalance()
-        let categoriesSpending = try await fetchCategorySpending()
-        let directDebits = try await fetchDirectDebits()
-        summary += "Balance : £\(balance.amount.minorUnits)"
-        summary += "The total spending of last month was £\(categoriesSpending.totalSpent). The top spendings are:"
-        for category in categoriesSpending.breakdown {
-            summary += "\(category.spendingCategory):£\(category.totalSpent)"
+
+    private enum FetchResult {
+        case balance(Balance, Duration)
+        case spendings(Spendings, Duration)
+        case directDebits(DirectDebits, Duration)
+    }
+
+    func summary(for account: AccountSnapshot) -> String {
+        prompt(for: account).text
+    }
+
+    func prompt(for account: AccountSnapshot) -> PromptBuilder {
+        let breakdown = account.spendings.breakdown
+        let mandates = account.directDebits.mandates
+        var prompt = PromptBuilder(capacity: 256 + 48 * (breakdown.count + mandates.count))
+        prompt.line("Hello \(customerName), hope you are doing great. We would like to provide a quick summary of your account and remind you of upcoming debits.")
+        prompt.record("balance", PromptBuilder.pounds(minorUnits: account.balance.amount.minorUnits))
+        prompt.record("spent last month", PromptBuilder.pounds(account.spendings.totalSpent))
+        prompt.line("top spendings (category|amount):")
+        for category in breakdown {
+            prompt.record(category.spendingCategory, PromptBuilder.pounds(category.totalSpent))
         }
+        prompt.line("upcoming debits (reference|amount|date):")
         var debitCost = 50
         var debitDate = 4
-        for debits in directDebits.mandates {
-            summary += "\(debits.reference):£\(debitCost) on March \(debitDate)th 2025"
+        for debits in mandates {
+            prompt.record(debits.reference, PromptBuilder.pounds(Double(debitCost)), String(format: "2025-03-%02d", debitDate))
             debitCost += 40
             debitDate += 4
         }
-        
-    
-        return summary
+        return prompt
     }
+
+    // Issues the three Starling requests at once. The first failure leaves the
+    // task group, which cancels the sibling requests still in flight.
+    func fetchAccount() async throws -> (AccountSnapshot, FetchTimings) {
+        let clock = ContinuousClock()
+        let start = clock.now
+        return try await withThrowingTaskGroup(of: FetchResult.self) { group in
+            group.addTask {
+                let (balance, elapsed) = try await measure { try await fetchBalance() }
+                return .balance(balance, elapsed)
+            }
+            group.addTask {
+                let (spendings, elapsed) = try await measure { try await fetchCategorySpending() }
+                return .spendings(spendings, elapsed)
+            }
+            group.addTask {
+                let (directDebits, elapsed) = try await measure { try await fetchDirectDebits() }
+                return .directDebits(directDebits, elapsed)
+            }
+
+            var balance: Balance?
+            var spendings: Spendings?
+            var directDebits: DirectDebits?
+            var timings = FetchTimings()
+            for try await result in group {
+                switch result {
+                case .balance(let value, let elapsed):
+                    balance = value
+                    timings.balance = elapsed
+                case .spendings(let value, let elapsed):
+                    spendings = value
+                    timings.spendings = elapsed
+                case .directDebits(let value, let elapsed):
+                    directDebits = value
+                    timings.directDebits = elapsed
+                }
+            }
+            guard let balance, let spendings, let directDebits else {
+                throw CancellationError()
+            }
+            timings.total = start.duration(to: clock.now)
+            return (AccountSnapshot(balance: balance, spendings: spendings, directDebits: directDebits), timings)
+        }
+    }
+
     private func fetchBalance() async throws -> Balance {
-        let url = URL(string: "https://api-sandbox.starlingbank.com/api/v2/accounts/<ACCOUNT UID>/balance")!
-        var urlRequest = URLRequest(url: url)
-        urlRequest.httpMethod = "GET"
-        urlRequest.setValue(accessToken, forHTTPHeaderField: "Authorization")
-        let (data,_) = try await URLSession.shared.data(for: urlRequest)
-        let balance = try JSONDecoder().decode(Balance.self, from: data)
-        return balance
+        try await fetch(span: "starling.balance", "accounts/\(accountUid)/balance")
     }
-    
+
     private func fetchCategorySpending() async throws -> Spendings {
-        let url = URL(string: "https://api-sandbox.starlingbank.com/api/v2/accounts/<ACCOUNT UID>/spending-insights/spending-category?year=2025&month=FEBRUARY")!
-        var urlRequest = URLRequest(url: url)
-        urlRequest.httpMethod = "GET"
-        urlRequest.setValue(accessToken, forHTTPHeaderField: "Authorization")
-        let (data,_) = try await URLSession.shared.data(for: urlRequest)
-        let spendings = try JSONDecoder().decode(Spendings.self, from: data)
-        return spendings
+        try await fetch(span: "starling.spendings", "accounts/\(accountUid)/spending-insights/spending-category",
+                        query: [URLQueryItem(name: "year", value: "2025"), URLQueryItem(name: "month", value: "FEBRUARY")])
     }
-    
+
     private func fetchDirectDebits() async throws -> DirectDebits {
-        let url = URL(string: "https://api-sandbox.starlingbank.com/api/v2/direct-debit/mandates/account/<ACCOUNT UID>")!
+        try await fetch(span: "starling.directDebits", "direct-debit/mandates/account/\(accountUid)")
+    }
+
+    private func fetch<T: Decodable & Sendable>(span: StaticString, _ path: String, query: [URLQueryItem] = []) async throws -> T {
+        try await Tracer.shared.trace(span) {
+            try await fetch(path, query: query)
+        }
+    }
+
+    private func fetch<T: Decodable & Sendable>(_ path: String, query: [URLQueryItem] = []) async throws -> T {
+        var url = baseURL.appending(path: path)
+        if !query.isEmpty {
+            url.append(queryItems: query)
+        }
         var urlRequest = URLRequest(url: url)
         urlRequest.httpMethod = "GET"
         urlRequest.setValue(accessToken, forHTTPHeaderField: "Authorization")
-        let (data,_) = try await URLSession.shared.data(for: urlRequest)
-        let directDebits = try JSONDecoder().decode(DirectDebits.self, from: data)
-        return directDebits
+        // Validators are handled here, so keep URLCache from answering the 304 itself.
+        urlRequest.cachePolicy = .reloadIgnoringLocalCacheData
+        let cached = await validators.entry(for: url)
+        if let cached {
+            if let etag = cached.etag {
+                urlRequest.setValue(etag, forHTTPHeaderField: "If-None-Match")
+            }
+            if let lastModified = cached.lastModified {
+                urlRequest.setValue(lastModified, forHTTPHeaderField: "If-Modified-Since")
+            }
+        }
+        let (data,response) = try await session.data(for: urlRequest)
+        guard let httpResponse = response as? HTTPURLResponse else {
+            return try JSONDecoder().decode(T.self, from: data)
+        }
+        if cached != nil {
+            await validators.recordRequest(notModified: httpResponse.statusCode == 304)
+        }
+        if httpResponse.statusCode == 304 {
+            guard let value = cached?.value as? T else {
+                throw URLError(.badServerResponse)
+            }
+            return value
+        }
+        guard (200..<300).contains(httpResponse.statusCode) else {
+            throw HTTPStatusError(statusCode: httpResponse.statusCode)
+        }
+        let value = try await Tracer.shared.trace("starling.decode") {
+            try JSONDecoder().decode(T.self, from: data)
+        }
+        await validators.store(value, for: url, response: httpResponse)
+        return value
+    }
+
+    private func measure<T: Sendable>(_ operation: @escaping @Sendable () async throws -> T) async throws -> (T, Duration) {
+        let clock = ContinuousClock()
+        let start = clock.now
+        let value = try await withDeadline(operation)
+        return (value, start.duration(to: clock.now))
+    }
+
+    private func withDeadline<T: Sendable>(_ operation: @escaping @Sendable () async throws -> T) async throws -> T {
+        try await withThrowingTaskGroup(of: T.self) { group in
+            group.addTask {
+                try await operation()
+            }
+            group.addTask {
+                try await Task.sleep(for: requestTimeout)
+                throw URLError(.timedOut)
+            }
+            defer { group.cancelAll() }
+            guard let value = try await group.next() else {
+                throw CancellationError()
+            }
+            return value
+        }
     }
 }
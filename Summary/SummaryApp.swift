@@ -6,9 +6,30 @@
 //
 
 import SwiftUI
+import TwilioVoice
 
 @main
 struct SummaryApp: App {
+    init() {
+        // Verbose SDK logs go through the buffered logger, so they stay off the call setup path.
+        TwilioVoiceSDK.logger = BufferedLogger.shared
+        TwilioVoiceSDK.logLevel = .debug
+        #if DEBUG
+        if PipelineBenchmark.isRequested {
+            Task {
+                let checks = await PipelineBenchmark().run() + AudioKernelBenchmark().run()
+                let failed = checks.filter { !$0.passed }.map(\.name)
+                if !failed.isEmpty {
+                    print("Benchmark checks failed: \(failed.joined(separator: ", "))")
+                    exit(1)
+                }
+                print("Benchmark checks passed: \(checks.count)")
+                exit(0)
+            }
+        }
+        #endif
+    }
+
     var body: some Scene {
         WindowGroup {
             ContentView()
@@ -0,0 +1,117 @@
+//
+//  SummaryCache.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import CryptoKit
+
+// On-disk cache of generated summaries, keyed by the prompts and model that
+// produced them. Entries expire after `timeToLive` and the
+// oldest ones are evicted once the directory grows past `maxBytes`.
+final class SummaryCache {
+
+    struct Stats {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+    }
+
+    private struct Entry:Codable {
+        var summary:String
+        var createdAt:Date
+    }
+
+    let directory:URL
+    let timeToLive:TimeInterval
+    let maxBytes:Int
+    private let lock = NSLock()
+    private var counters = Stats()
+    private let fileManager = FileManager.default
+
+    init(directory:URL = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appending(path: "summaries"),
+         timeToLive:TimeInterval = 24 * 60 * 60,
+         maxBytes:Int = 1_000_000) {
+        self.directory = directory
+        self.timeToLive = timeToLive
+        self.maxBytes = maxBytes
+        try? fileManager.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    var stats:Stats {
+        lock.withLock { counters }
+    }
+
+    // Keyed on the rendered user prompt rather than the snapshot, so the customer
+    // name, the prompt template and compaction all count, not only the account data.
+    static func key(userPrompt:String, systemPrompt:String, model:String) -> String {
+        var hasher = SHA256()
+        hasher.update(data: Data(userPrompt.utf8))
+        hasher.update(data: Data([0]))
+        hasher.update(data: Data(systemPrompt.utf8))
+        hasher.update(data: Data([0]))
+        hasher.update(data: Data(model.utf8))
+        return hasher.finalize().map { String(format: "%02x", $0) }.joined()
+    }
+
+    func summary(forKey key:String) -> String? {
+        let url = fileURL(forKey: key)
+        guard let data = try? Data(contentsOf: url),
+              let entry = try? JSONDecoder().decode(Entry.self, from: data) else {
+            lock.withLock { counters.misses += 1 }
+            return nil
+        }
+        if Date().timeIntervalSince(entry.createdAt) > timeToLive {
+            try? fileManager.removeItem(at: url)
+            lock.withLock {
+                counters.misses += 1
+                counters.evictions += 1
+            }
+            return nil
+        }
+        // Touch the file so eviction drops the least recently used entries first.
+        try? fileManager.setAttributes([.modificationDate: Date()], ofItemAtPath: url.path)
+        lock.withLock { counters.hits += 1 }
+        return entry.summary
+    }
+
+    func store(_ summary:String, forKey key:String) {
+        guard let data = try? JSONEncoder().encode(Entry(summary: summary, createdAt: Date())) else {
+            return
+        }
+        do {
+            try data.write(to: fileURL(forKey: key), options: .atomic)
+        } catch {
+            print("Failed to cache summary \(error.localizedDescription)")
+            return
+        }
+        evictIfNeeded()
+    }
+
+    private func evictIfNeeded() {
+        let keys:[URLResourceKey] = [.contentModificationDateKey, .fileSizeKey]
+        guard let urls = try? fileManager.contentsOfDirectory(at: directory, includingPropertiesForKeys: keys) else {
+            return
+        }
+        var files = urls.compactMap { url -> (url:URL, modified:Date, size:Int)? in
+            guard let values = try? url.resourceValues(forKeys: Set(keys)) else { return nil }
+            return (url, values.contentModificationDate ?? .distantPast, values.fileSize ?? 0)
+        }
+        var totalBytes = files.reduce(0) { $0 + $1.size }
+        guard totalBytes > maxBytes else { return }
+        files.sort { $0.modified < $1.modified }
+        var evicted = 0
+        for file in files where totalBytes > maxBytes {
+            if (try? fileManager.removeItem(at: file.url)) != nil {
+                totalBytes -= file.size
+                evicted += 1
+            }
+        }
+        lock.withLock { counters.evictions += evicted }
+    }
+
+    private func fileURL(forKey key:String) -> URL {
+        directory.appending(path: "\(key).json")
+    }
+}
@@ -0,0 +1,272 @@
+//
+//  SummaryPlaybackCapturer.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import AVFoundation
+import TwilioVoice
+
+// Capturer that plays a pre-rendered summary as the outgoing call audio instead
+// of the microphone. The summary is synthesized once per text and format and kept
+// in PCMAssetStore, whose shared mapping is played in place. CaptureReframer cuts
+// it into `framesPerBuffer` chunks for the SDK, so speech starts with the first
+// capture buffer, repeat calls skip TTS, and only the padded tail is copied.
+final class SummaryPlaybackCapturer:NSObject, AudioDeviceCapturer {
+
+    // Defaults to AudioDeviceWriteCaptureData; replace it to capture into memory.
+    typealias CaptureWriter = (AudioDeviceContext, UnsafeMutablePointer<Int8>, Int) -> Void
+
+    // Longest TTS is given before `prepare` gives up on it; rendering runs well ahead of real time.
+    static let synthesisTimeout = Duration.seconds(30)
+
+    let format:AudioFormat
+    let profiler:AudioCallbackProfiler
+    // Called on main once the summary has played out, so the call can be hung up.
+    var onFinished:(() -> Void)?
+    let meter = AudioLevelMeter()
+    private let writer:CaptureWriter
+    private let store:PCMAssetStore
+    private let queue = DispatchQueue(label: "SummaryPlaybackCapturer", qos: .userInteractive)
+    private let silence:UnsafeMutablePointer<Int16>
+    private let chunk:Int
+    // The fields below are only touched on queue.
+    private let reframer:CaptureReframer
+    private var asset:PCMAsset?
+    private var assetKey:String?
+    // Only used when the asset could not be written.
+    private var buffers = [AVAudioPCMBuffer]()
+    private var timer:DispatchSourceTimer?
+    private var finished = false
+
+    init(format:AudioFormat = RingBufferAudioDevice.preferredFormat(),
+         store:PCMAssetStore = .shared,
+         writer: @escaping CaptureWriter = { AudioDeviceWriteCaptureData(context: $0, data: $1, sizeInBytes: $2) }) {
+        self.format = format
+        self.store = store
+        self.writer = writer
+        profiler = AudioCallbackProfiler(name: "summary capture", framesPerBuffer: format.framesPerBuffer, sampleRate: Int(format.sampleRate))
+        chunk = format.framesPerBuffer * format.numberOfChannels
+        silence = .allocate(capacity: chunk)
+        silence.initialize(repeating: 0, count: chunk)
+        reframer = CaptureReframer(framesPerBuffer: format.framesPerBuffer, channels: format.numberOfChannels)
+        super.init()
+    }
+
+    deinit {
+        timer?.cancel()
+        silence.deallocate()
+    }
+
+    // Synthesizes the summary unless the same text has already been rendered for this format.
+    // A no-op when this summary is already loaded, and never swaps the audio under a call that is playing it.
+    func prepare(summary:String) async {
+        let key = PCMAssetStore.key(summary: summary, format: format)
+        let loaded = queue.sync { assetKey == key && (asset != nil || !buffers.isEmpty) }
+        guard !loaded else { return }
+        var asset = store.asset(forKey: key)
+        var buffers = [AVAudioPCMBuffer]()
+        if asset == nil {
+            buffers = await SummaryPlaybackCapturer.synthesize(summary, format: format)
+        }
+        if asset == nil && !buffers.isEmpty {
+            let trimmer = SilenceTrimmer(sampleRate: Int(format.sampleRate), channels: format.numberOfChannels, framesPerBuffer: format.framesPerBuffer)
+            do {
+                asset = try store.write(buffers, format: format, forKey: key, trimmer: trimmer)
+                buffers = []
+                print("Trimmed \(trimmer.stats.trimmedDuration) of silence from \(trimmer.stats.inputDuration) of summary audio")
+            } catch {
+                print("Failed to store summary audio \(error.localizedDescription)")
+            }
+        }
+        queue.sync {
+            guard timer == nil else {
+                print("Summary call in progress, keeping its audio")
+                return
+            }
+            self.asset = asset
+            assetKey = key
+            self.buffers = buffers
+            rewind()
+        }
+    }
+
+    // Lets go of the summary audio once the call has ended, so its mapping is
+    // unmapped. The next `prepare` maps it again from disk.
+    func release() {
+        let key = queue.sync { () -> String? in
+            reframer.reset()
+            asset = nil
+            buffers = []
+            defer { assetKey = nil }
+            return assetKey
+        }
+        if let key {
+            store.release(forKey: key)
+        }
+    }
+
+    // Bytes copied while reframing, for comparing against copying the whole summary.
+    var copiedBytes:Int {
+        queue.sync { reframer.copiedBytes }
+    }
+
+    // MARK: AudioDeviceCapturer
+
+    func captureFormat() -> AudioFormat? {
+        format
+    }
+
+    func initializeCapturer() -> Bool {
+        true
+    }
+
+    func startCapturing(_ context: AudioDeviceContext) -> Bool {
+        queue.sync {
+            rewind()
+            profiler.reset()
+            let timer = DispatchSource.makeTimerSource(flags: .strict, queue: queue)
+            timer.schedule(deadline: .now(), repeating: Double(format.framesPerBuffer) / Double(format.sampleRate), leeway: .microseconds(500))
+            timer.setEventHandler { [weak self] in
+                self?.writeNextChunk(to: context)
+            }
+            self.timer = timer
+            timer.resume()
+        }
+        return true
+    }
+
+    func stopCapturing() -> Bool {
+        queue.sync {
+            timer?.cancel()
+            timer = nil
+        }
+        meter.reset()
+        return true
+    }
+
+    // MARK: Playback
+
+    private func rewind() {
+        finished = false
+        reframer.reset()
+        if let asset {
+            reframer.append(asset.samples, count: asset.sampleCount, owner: asset)
+            return
+        }
+        for buffer in buffers {
+            guard let data = buffer.int16ChannelData else { continue }
+            reframer.append(data[0], count: Int(buffer.frameLength) * format.numberOfChannels, owner: buffer)
+        }
+    }
+
+    private func writeNextChunk(to context:AudioDeviceContext) {
+        let start = profiler.begin()
+        defer { profiler.end(start) }
+        let bytes = chunk * MemoryLayout<Int16>.size
+        // AudioDeviceWriteCaptureData takes a mutable pointer. Asset mappings are
+        // copy-on-write and the TTS buffers are ours, so both are passed without a copy.
+        let write = { (samples:UnsafePointer<Int16>) in
+            self.meter.measure(samples, count: self.chunk)
+            UnsafeMutablePointer(mutating: samples).withMemoryRebound(to: Int8.self, capacity: bytes) { data in
+                self.writer(context, data, bytes)
+            }
+        }
+        // Whole buffers first, then the padded tail, then silence until the call is hung up.
+        if !reframer.emit(write) && !reframer.emitRemainder(write) {
+            // Re-zeroed each time in case the SDK wrote into the last one.
+            silence.update(repeating: 0, count: chunk)
+            write(silence)
+            if !finished {
+                finished = true
+                DispatchQueue.main.async { [weak self] in
+                    self?.onFinished?()
+                }
+            }
+        }
+    }
+
+    // MARK: Synthesis
+
+    private final class Synthesis {
+        var buffers = [AVAudioPCMBuffer]()
+        var converter:AVAudioConverter?
+        var supplied = false
+        private let lock = NSLock()
+        private var continuation:CheckedContinuation<[AVAudioPCMBuffer], Never>?
+
+        init(continuation:CheckedContinuation<[AVAudioPCMBuffer], Never>) {
+            self.continuation = continuation
+        }
+
+        var isFinished:Bool {
+            lock.withLock { continuation == nil }
+        }
+
+        // Resumes the caller once, with the rendered buffers, or with none when
+        // synthesis was given up on. False when it had already been resumed.
+        func finish(with buffers:[AVAudioPCMBuffer]) -> Bool {
+            guard let continuation = lock.withLock({ () -> CheckedContinuation<[AVAudioPCMBuffer], Never>? in
+                defer { self.continuation = nil }
+                return self.continuation
+            }) else { return false }
+            continuation.resume(returning: buffers)
+            return true
+        }
+    }
+
+    // AVSpeechSynthesizer signals the end only with an empty buffer, so a
+    // synthesis that never delivers one is abandoned after `synthesisTimeout`.
+    private static func synthesize(_ text:String, format:AudioFormat) async -> [AVAudioPCMBuffer] {
+        guard let target = AVAudioFormat(commonFormat: .pcmFormatInt16,
+                                         sampleRate: Double(format.sampleRate),
+                                         channels: AVAudioChannelCount(format.numberOfChannels),
+                                         interleaved: true) else {
+            return []
+        }
+        let synthesizer = AVSpeechSynthesizer()
+        let utterance = AVSpeechUtterance(string: text)
+        return await withCheckedContinuation { continuation in
+            let synthesis = Synthesis(continuation: continuation)
+            // Also keeps the synthesizer alive while it renders.
+            DispatchQueue.global().asyncAfter(deadline: .now() + synthesisTimeout.timeInterval) {
+                if synthesis.finish(with: []) {
+                    print("Summary synthesis timed out after \(synthesisTimeout)")
+                    synthesizer.stopSpeaking(at: .immediate)
+                }
+            }
+            synthesizer.write(utterance) { buffer in
+                guard !synthesis.isFinished else { return }
+                guard let buffer = buffer as? AVAudioPCMBuffer, buffer.frameLength > 0 else {
+                    _ = synthesis.finish(with: synthesis.buffers)
+                    return
+                }
+                if synthesis.converter == nil {
+                    synthesis.converter = AVAudioConverter(from: buffer.format, to: target)
+                }
+                guard let converter = synthesis.converter else { return }
+                let capacity = AVAudioFrameCount(Double(buffer.frameLength) * target.sampleRate / buffer.format.sampleRate) + 1
+                guard let output = AVAudioPCMBuffer(pcmFormat: target, frameCapacity: capacity) else { return }
+                synthesis.supplied = false
+                var error:NSError?
+                converter.convert(to: output, error: &error) { _, status in
+                    if synthesis.supplied {
+                        status.pointee = .noDataNow
+                        return nil
+                    }
+                    synthesis.supplied = true
+                    status.pointee = .haveData
+                    return buffer
+                }
+                if let error {
+                    print("Failed to convert summary audio \(error.localizedDescription)")
+                    return
+                }
+                if output.frameLength > 0 {
+                    synthesis.buffers.append(output)
+                }
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
 
 import Foundation
 import Combine
+import TwilioVoice
 
 struct ChatResponse:Decodable {
     var choices:[Choice]
@@ -22,66 +23,184 @@ struct Message:Decodable {
     var content:String
 }
 
-struct Balance:Decodable {
+struct ChatStreamChunk:Decodable {
+    var choices:[StreamChoice]
+}
+
+struct StreamChoice:Decodable {
+    var index:Int
+    var delta:Delta
+}
+
+struct Delta:Decodable {
+    var role:String?
+    var content:String?
+}
+
+struct Balance:Codable {
     var amount:Amount
 }
 
-struct Amount:Decodable {
+struct Amount:Codable {
     var currency:String
     var minorUnits:Int
 }
 
-struct Spendings:Decodable {
+struct Spendings:Codable {
     var totalSpent:Double
     var breakdown:[Category]
 }
 
-struct Category:Decodable {
+struct Category:Codable {
     var spendingCategory: String
     var totalSpent: Double
 }
 
-struct DirectDebits:Decodable {
+struct DirectDebits:Codable {
     var mandates:[Mandate]
 }
 
-struct Mandate:Decodable {
+struct Mandate:Codable {
     var reference:String
     var status:String
 }
 
+struct AccountSnapshot:Codable {
+    var balance:Balance
+    var spendings:Spendings
+    var directDebits:DirectDebits
+}
+
 class SummaryViewModel:ObservableObject {
-    private var cancellables = Set<AnyCancellable>()
     private var twilioService = TwilioService()
     private var chatgptService = ChatGPTService()
     private var starlingService = StarlingService()
+    private let summaryCache = SummaryCache()
+    private let promptCompactor = PromptCompactor()
+    private let playbackCapturer = SummaryPlaybackCapturer()
+    private let callObserver = SummaryCallObserver()
+    private var activeCall:Call?
+    // Left after the summary ends so the last words are not clipped.
+    private let hangUpDelay = Duration.milliseconds(1500)
     
-    @Published var summaryText = "Hello there 😃, Get a summary of your Starling bank account. Click on the button below to fetch your starling bank details."
+    @Published var isCalling = false
+    private static let placeholder = "Hello there 😃, Get a summary of your Starling bank account. Click on the button below to fetch your starling bank details."
+    @Published var summaryText = SummaryViewModel.placeholder
 
     
     func getSummary(completion: @escaping (Bool) -> Void) async throws {
-        let content =  try await starlingService.fetchSummary()
-        chatgptService.getSummary(content: content)
-            .receive(on: DispatchQueue.main)
-            .sink { response in
-                switch response {
-                case .failure(let error):
-                    print("Error getting response from chatgpt service \(error.localizedDescription)")
-                case .finished:
-                    print("Successfully fetched chatgpt response")
+        defer {
+            Tracer.shared.write(to: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0].appending(path: "summary-trace.json"))
+        }
+        try await Tracer.shared.trace("summary") {
+            try await summarize(completion: completion)
+        }
+    }
+    
+    private func summarize(completion: @escaping (Bool) -> Void) async throws {
+        let tracer = Tracer.shared
+        let fetched = try await tracer.trace("starling.fetch") {
+            try await starlingService.fetchAccount()
+        }
+        let account = fetched.0
+        #if DEBUG
+        // The whole fetch is already a trace span; this splits it per endpoint.
+        print("Fetched starling account in \(fetched.1)")
+        #endif
+        let prompt = await tracer.trace("prompt.build") {
+            let compacted = promptCompactor.compact(account, using: starlingService)
+            return starlingService.prompt(for: compacted)
+        }
+        let content = prompt.text
+        let cacheKey = SummaryCache.key(userPrompt: content, systemPrompt: ChatGPTService.systemPrompt, model: ChatGPTService.model)
+        let cachedSummary = await tracer.trace("cache.lookup") {
+            summaryCache.summary(forKey: cacheKey)
+        }
+        if let cachedSummary {
+            print("Using cached summary \(summaryCache.stats)")
+            await tracer.trace("ui.update") {
+                await MainActor.run {
+                    self.summaryText = cachedSummary
+                    completion(true)
                 }
-                completion(true)
-            } receiveValue: { chatResponse in
-                if let choice = chatResponse.choices.first {
-                    self.summaryText = choice.message.content
-                } else {
-                    print("Failed to fetch chat gpt response")
+            }
+            await playbackCapturer.prepare(summary: cachedSummary)
+            return
+        }
+        var summary = ""
+        do {
+            try await tracer.trace("chatgpt.stream") {
+                for try await delta in chatgptService.streamSummary(content: content) {
+                    let replacesPlaceholder = summary.isEmpty
+                    summary += delta
+                    if replacesPlaceholder {
+                        await tracer.trace("ui.firstDelta") {
+                            await MainActor.run {
+                                self.summaryText = delta
+                            }
+                        }
+                    } else {
+                        await MainActor.run {
+                            self.summaryText += delta
+                        }
+                    }
                 }
             }
-            .store(in: &cancellables)
+            print("Successfully fetched chatgpt response")
+        } catch {
+            print("Error getting response from chatgpt service \(error.localizedDescription)")
+            summary = ""
+        }
+        if summary.isEmpty {
+            // A partial summary is neither shown nor spoken on the call.
+            print("Failed to fetch chat gpt response")
+            await MainActor.run {
+                self.summaryText = SummaryViewModel.placeholder
+                completion(false)
+            }
+            return
+        }
+        summaryCache.store(summary, forKey: cacheKey)
+        await tracer.trace("ui.update") {
+            await MainActor.run {
+                completion(true)
+            }
+        }
+        // Render the call audio now so placing the call does not wait on TTS.
+        await playbackCapturer.prepare(summary: summary)
     }
     
+    // Read directly by the level meter view every frame; not published.
+    var captureLevel:AudioLevelMeter.Level {
+        playbackCapturer.meter.level
+    }
+
+    // Main actor, so activeCall is only ever read and written on main.
+    @MainActor
     func callWithSummary() {
-        twilioService.makeTheCallService(content: summaryText)
+        guard !isCalling, activeCall == nil else { return }
+        let summary = summaryText
+        isCalling = true
+        callObserver.onEnded = { [weak self] in
+            DispatchQueue.main.async {
+                self?.isCalling = false
+                self?.activeCall = nil
+                self?.playbackCapturer.release()
+            }
+        }
+        // The summary is all the call is for, so hang up once it has been spoken.
+        playbackCapturer.onFinished = { [weak self] in
+            guard let self, let call = activeCall else { return }
+            DispatchQueue.main.asyncAfter(deadline: .now() + hangUpDelay.timeInterval) {
+                call.disconnect()
+            }
+        }
+        let accessToken = twilioService.voiceAccessToken
+        Task {
+            // The preflight and TTS are independent; run them side by side.
+            async let verdict = PreflightService.shared.verdict(accessToken: accessToken)
+            await playbackCapturer.prepare(summary: summary)
+            activeCall = twilioService.connectWithSummary(capturer: playbackCapturer, verdict: await verdict, delegate: callObserver)
+        }
     }
 }
@@ -0,0 +1,149 @@
+//
+//  Tracer.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+import os
+
+// Lightweight span recorder for the summary pipeline. Spans are written into a
+// fixed-size ring allocated up front, timestamps come from the monotonic uptime
+// clock, and nesting follows the task tree through task-local parent and root
+// ids. `export()` produces Chrome trace-event JSON (chrome://tracing, Perfetto)
+// with the rows grouped by root span.
+final class Tracer {
+
+    struct Span {
+        var id:UInt64 = 0
+        var parent:UInt64 = 0
+        var root:UInt64 = 0
+        var name:StaticString = ""
+        var start:UInt64 = 0
+        var end:UInt64 = 0
+    }
+
+    private struct Ring {
+        var spans:[Span]
+        var next = 0
+        var count = 0
+        var lastID:UInt64 = 0
+    }
+
+    static let shared = Tracer()
+
+    @TaskLocal static var currentSpan:UInt64 = 0
+    @TaskLocal static var currentRoot:UInt64 = 0
+
+    private let ring:OSAllocatedUnfairLock<Ring>
+
+    init(capacity:Int = 1024) {
+        ring = OSAllocatedUnfairLock(initialState: Ring(spans: Array(repeating: Span(), count: max(1, capacity))))
+    }
+
+    static func now() -> UInt64 {
+        clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+    }
+
+    func trace<T>(_ name:StaticString, _ operation: () async throws -> T) async rethrows -> T {
+        let parent = Tracer.currentSpan
+        let id = ring.withLock { ring -> UInt64 in
+            ring.lastID += 1
+            return ring.lastID
+        }
+        let root = parent == 0 ? id : Tracer.currentRoot
+        let start = Tracer.now()
+        defer { record(Span(id: id, parent: parent, root: root, name: name, start: start, end: Tracer.now())) }
+        return try await Tracer.$currentRoot.withValue(root) {
+            try await Tracer.$currentSpan.withValue(id) {
+                try await operation()
+            }
+        }
+    }
+
+    // Records work timed elsewhere, e.g. by URLSession, as a root span of its own.
+    // The dates are mapped onto the uptime clock by their age now.
+    func record(_ name:StaticString, interval:DateInterval) {
+        let id = ring.withLock { ring -> UInt64 in
+            ring.lastID += 1
+            return ring.lastID
+        }
+        let now = Tracer.now()
+        let age = UInt64(max(0, Date().timeIntervalSince(interval.start)) * 1e9)
+        let start = now - min(now, age)
+        record(Span(id: id, parent: 0, root: id, name: name, start: start, end: start + UInt64(max(0, interval.duration) * 1e9)))
+    }
+
+    func record(_ span:Span) {
+        ring.withLock { ring in
+            ring.spans[ring.next] = span
+            ring.next = (ring.next + 1) % ring.spans.count
+            ring.count = min(ring.count + 1, ring.spans.count)
+        }
+    }
+
+    // Oldest first.
+    func snapshot() -> [Span] {
+        ring.withLock { ring in
+            let start = (ring.next - ring.count + ring.spans.count) % ring.spans.count
+            return (0..<ring.count).map { ring.spans[(start + $0) % ring.spans.count] }
+        }
+    }
+
+    func export() throws -> Data {
+        var events = [[String:Any]]()
+        for (tid, spans) in rows() {
+            events.append(["name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": ["name": "\(spans[0].name) #\(spans[0].root)"]])
+            for span in spans {
+                events.append([
+                    "name": span.name.description,
+                    "ph": "X",
+                    "ts": Double(span.start) / 1000,
+                    "dur": Double(span.end - span.start) / 1000,
+                    "pid": 1,
+                    "tid": tid,
+                    "args": ["id": span.id, "parent": span.parent, "root": span.root]
+                ])
+            }
+        }
+        return try JSONSerialization.data(withJSONObject: ["traceEvents": events, "displayTimeUnit": "ms"], options: [.prettyPrinted])
+    }
+
+    // Spans grouped by root, each root on its own row. Slices on a row must nest,
+    // so a span that overlaps a sibling, e.g. concurrent fetches, moves to an
+    // extra row under its root's. Rows are numbered from 1 in order of first start.
+    private func rows() -> [(tid:Int, spans:[Span])] {
+        let spans = snapshot().sorted { ($0.start, $1.end) < ($1.start, $0.end) }
+        var rows = [(tid:Int, spans:[Span])]()
+        // Per row, the spans still open at the current start time, outermost first.
+        var open = [[Span]]()
+        var rowsByRoot = [UInt64:[Int]]()
+        for span in spans {
+            var target:Int?
+            for row in rowsByRoot[span.root, default: []] {
+                open[row].removeAll { $0.end <= span.start }
+                if open[row].last.map({ $0.end >= span.end }) ?? true {
+                    target = row
+                    break
+                }
+            }
+            let row = target ?? rows.count
+            if target == nil {
+                rows.append((rows.count + 1, []))
+                open.append([])
+                rowsByRoot[span.root, default: []].append(row)
+            }
+            rows[row].spans.append(span)
+            open[row].append(span)
+        }
+        return rows
+    }
+
+    func write(to url:URL) {
+        do {
+            try export().write(to: url, options: .atomic)
+        } catch {
+            print("Failed to write trace \(error.localizedDescription)")
+        }
+    }
+}
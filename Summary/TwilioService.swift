@@ -5,22 +5,66 @@
 //  Created by Kouv on 25/02/2025.
 //
 import Foundation
+import TwilioVoice
 
 struct TwilioService {
-    
-    func makeTheCallService(content:String) {
+
+    var session = NetworkClient.shared.session
+    var voiceAccessToken = "<VOICE ACCESS TOKEN>"
+
+    func placeCall(content:String) async throws {
+        let (_,response) = try await session.data(for: makeRequest(content: content))
+        if let httpResponse = response as? HTTPURLResponse,!(200..<300).contains(httpResponse.statusCode) {
+            throw HTTPStatusError(statusCode: httpResponse.statusCode)
+        }
+    }
+
+    // Places the call through the Voice SDK with the pre-rendered summary as the outgoing audio, so Twilio does not run TTS.
+    // A preflight verdict for the current network caps the codec bitrate and can force TURN relay;
+    // otherwise IceConfigurationManager picks the transport policy from past connects.
+    func connectWithSummary(capturer:SummaryPlaybackCapturer, verdict:PreflightVerdict? = nil, delegate:CallDelegate) -> Call {
+        TwilioVoiceSDK.audioDevice = RingBufferAudioDevice(format: capturer.format, capturer: capturer)
+        let options = ConnectOptions(accessToken: voiceAccessToken) { builder in
+            builder.params = ["To": "<TO_NUMBER_GOES_HERE>"]
+            builder.preferredAudioCodecs = CallQualityController.shared.preferredAudioCodecs(ceiling: verdict?.opusBitrate)
+            builder.iceOptions = IceConfigurationManager.shared.iceOptions(forceRelay: verdict?.relayOnly == true)
+            builder.audioOptions = JitterBufferTuner.shared.audioOptions(for: PreflightService.shared.currentNetwork)
+        }
+        return TwilioVoiceSDK.connect(options: options, delegate: delegate)
+    }
+
+    private func makeRequest(content:String) -> URLRequest {
         var urlRequest = URLRequest(url: URL(string: "https://api.twilio.com/2010-04-01/Accounts/<ACCOUNT SID>/Calls.json")!)
         urlRequest.httpMethod = "POST"
         let authData = ("ACCOUNT SID:AUTH TOKEN").data(using: .utf8)!.base64EncodedString()
         urlRequest.setValue("application/x-www-form-urlencoded", forHTTPHeaderField: "Content-Type")
         urlRequest.setValue("Basic \(authData)", forHTTPHeaderField: "Authorization")
         urlRequest.httpBody = "To=<TO_NUMBER_GOES_HERE>&From=<FROM_NUMBER_GOES_HERE>&Twiml=<Response><Say>\(content)</Say></Response>".data(using: .utf8)
-        
-        URLSession.shared.dataTask(with: urlRequest) { _, response, error in
-            if let httpResponse = response as? HTTPURLResponse,httpResponse.statusCode != 200 {
-                print("Error calling user \(error?.localizedDescription ?? "Twilio error")")
-            }
-        }.resume()
-            
+        return urlRequest
+    }
+}
+
+final class SummaryCallObserver:NSObject, CallDelegate {
+
+    var onEnded:(() -> Void)?
+
+    func callDidConnect(call: Call) {
+        print("Summary call connected \(call.sid)")
+        CallQualityController.shared.start(call: call)
+    }
+
+    func callDidFailToConnect(call: Call, error: Error) {
+        print("Summary call failed to connect \(error.localizedDescription)")
+        IceConfigurationManager.shared.recordConnectFailure()
+        onEnded?()
+    }
+
+    func callDidDisconnect(call: Call, error: Error?) {
+        print("Summary call disconnected \(error?.localizedDescription ?? "")")
+        CallQualityController.shared.stop()
+        if let device = TwilioVoiceSDK.audioDevice as? RingBufferAudioDevice {
+            device.callbackReports.forEach { print("Audio callbacks \($0)") }
+        }
+        onEnded?()
     }
 }
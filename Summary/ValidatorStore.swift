@@ -0,0 +1,56 @@
+//
+//  ValidatorStore.swift
+//  Summary
+//
+//  Created by Kouv on 17/10/2026.
+//
+import Foundation
+
+// Remembers the ETag/Last-Modified validators and the decoded body for each
+// endpoint, so a 304 Not Modified response can reuse the previous value.
+actor ValidatorStore {
+
+    struct Entry {
+        var etag:String?
+        var lastModified:String?
+        var value:any Sendable
+    }
+
+    struct Stats {
+        var conditionalRequests = 0
+        var notModified = 0
+    }
+
+    private var entries = [URL:Entry]()
+    private(set) var stats = Stats()
+
+    func entry(for url:URL) -> Entry? {
+        entries[url]
+    }
+
+    func store(_ value:any Sendable, for url:URL, response:HTTPURLResponse) {
+        let etag = response.value(forHTTPHeaderField: "ETag")
+        let lastModified = response.value(forHTTPHeaderField: "Last-Modified")
+        if etag == nil && lastModified == nil {
+            entries[url] = nil
+            return
+        }
+        entries[url] = Entry(etag: etag, lastModified: lastModified, value: value)
+    }
+
+    func recordRequest(notModified:Bool) {
+        stats.conditionalRequests += 1
+        if notModified {
+            stats.notModified += 1
+        }
+    }
+
+    // Drops the entries whose URL names the account, e.g. once a batch has finished with it.
+    func removeEntries(forAccount accountUid:String) {
+        entries = entries.filter { !$0.key.pathComponents.contains(accountUid) }
+    }
+
+    func removeAll() {
+        entries.removeAll()
+    }
+}